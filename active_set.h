@@ -0,0 +1,74 @@
+#ifndef ACTIVE_SET_H
+#define ACTIVE_SET_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Subset of the indices [0, n) kept as a dense array with a position map.
+ *
+ * Members occupy the first size() slots of the array, in no particular order, and every index
+ * outside the set sits in a slot after them, so removal swaps an index with the last member and
+ * insertion swaps it with the first non-member, both O(1). Because nothing is ever erased from
+ * the array, reset() makes every index a member again by restoring the member count: O(1),
+ * whatever was removed. Iterating [begin(), end()) visits members only, back to back in memory.
+ */
+class ActiveSet {
+public:
+    ActiveSet() = default;
+
+    /**
+     * @brief Set of all indices [0, n).
+     */
+    explicit ActiveSet(int n) : dense_(n), pos_(n), size_(n) {
+        for (int i = 0; i < n; ++i) dense_[i] = pos_[i] = i;
+    }
+
+    /**
+     * @brief Makes every index a member again. O(1).
+     */
+    void reset() { size_ = static_cast<int>(dense_.size()); }
+
+    bool contains(int i) const { return pos_[i] < size_; }
+
+    /**
+     * @brief Drops i from the set. No-op if it is not a member.
+     */
+    void remove(int i) {
+        if (!contains(i)) return;
+        moveTo(i, --size_);
+    }
+
+    /**
+     * @brief Adds i to the set. No-op if it is already a member.
+     */
+    void insert(int i) {
+        if (contains(i)) return;
+        moveTo(i, size_++);
+    }
+
+    int size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief The member in slot k, for 0 <= k < size().
+     */
+    int operator[](int k) const { return dense_[k]; }
+
+    const int* begin() const { return dense_.data(); }
+    const int* end() const { return dense_.data() + size_; }
+
+private:
+    // Swaps i into slot `slot`, and that slot's index into i's old slot.
+    void moveTo(int i, int slot) {
+        const int other = dense_[slot];
+        std::swap(dense_[pos_[i]], dense_[slot]);
+        pos_[other] = pos_[i];
+        pos_[i] = slot;
+    }
+
+    std::vector<int> dense_, pos_;
+    int size_ = 0;
+};
+
+#endif // ACTIVE_SET_H
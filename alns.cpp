@@ -0,0 +1,656 @@
+#include "alns.h"
+#include "route_improvement.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace {
+
+const int DRY = 0, PER = 1, OTH = 2;
+const double kEps = 1e-9;
+
+// Ropke & Pisinger style operator scoring.
+const double kScoreNewBest = 33.0;
+const double kScoreBetter = 9.0;
+const double kScoreAccepted = 13.0;
+const double kReaction = 0.1;
+const double kMinWeight = 0.1;
+const int kSegmentLength = 100;
+
+// Search shape.
+const int kMinRemoval = 2;
+const int kMaxRemoval = 40;
+const double kMaxRemovalFraction = 0.3;
+const double kWorstTripBias = 3.0;
+const long kRestartAfter = 2000;
+const double kInitialTemperatureFraction = 0.0005;
+const double kFinalTemperatureRatio = 0.001;
+
+} // namespace
+
+AlnsSearch::AlnsSearch(const ProblemData& problem, const DistanceCache& dist, const VillageGrid& grid, unsigned seed,
+                       const NeighborLists* neighbors)
+    : problem_(problem), dist_(dist), grid_(grid), neighbors_(neighbors), gen_(seed),
+      stamp_(problem.villages.size(), 0),
+      heli_journal_stamp_(problem.helicopters.size(), 0),
+      village_journal_stamp_(problem.villages.size(), 0),
+      destroy_weights_(NUM_DESTROY, 1.0), repair_weights_(NUM_REPAIR, 1.0),
+      destroy_scores_(NUM_DESTROY, 0.0), repair_scores_(NUM_REPAIR, 0.0),
+      destroy_uses_(NUM_DESTROY, 0), repair_uses_(NUM_REPAIR, 0) {
+    auto density = [&](int type) {
+        double w = problem_.packages[type].weight;
+        return w > kEps ? problem_.packages[type].value / w : numeric_limits<double>::max();
+    };
+    order_[0] = DRY;
+    order_[1] = PER;
+    order_[2] = OTH;
+    stable_sort(order_, order_ + 3, [&](int a, int b) { return density(a) > density(b); });
+}
+
+// --- LOADS AND BOOKKEEPING ---
+
+AlnsSearch::Load AlnsSearch::bestLoad(double capacity, int food_need, int other_need) const {
+    Load load;
+    int food_left = max(0, food_need), other_left = max(0, other_need);
+    for (int type : order_) {
+        int limit = (type == OTH) ? other_left : food_left;
+        if (limit <= 0) continue;
+        double w = problem_.packages[type].weight;
+        int units = limit;
+        if (w > kEps) units = static_cast<int>(min<double>(limit, floor(capacity / w)));
+        if (units <= 0) continue;
+        capacity -= units * w;
+        if (type == DRY) load.dry = units;
+        else if (type == PER) load.perishable = units;
+        else load.other = units;
+        if (type == OTH) other_left -= units;
+        else food_left -= units;
+        load.value += units * problem_.packages[type].value;
+    }
+    return load;
+}
+
+double AlnsSearch::tripWeight(const RouteTrip& t) const {
+    return (t.dry * problem_.packages[DRY].weight) + (t.perishable * problem_.packages[PER].weight) + (t.other * problem_.packages[OTH].weight);
+}
+
+double AlnsSearch::tripCost(int h, const RouteTrip& t) const {
+    const auto& helicopter = problem_.helicopters[h];
+    return t.drops.empty() ? 0.0 : helicopter.fixed_cost + helicopter.alpha * t.distance;
+}
+
+double AlnsSearch::dropValue(const Drop& d) const {
+    return d.dry_food * problem_.packages[DRY].value + d.perishable_food * problem_.packages[PER].value + d.other_supplies * problem_.packages[OTH].value;
+}
+
+void AlnsSearch::refreshTrip(int h, RouteTrip& t) {
+    t.dry = t.perishable = t.other = 0;
+    for (const auto& d : t.drops) {
+        t.dry += d.dry_food;
+        t.perishable += d.perishable_food;
+        t.other += d.other_supplies;
+    }
+    t.distance = dist_.tripDistance(problem_.helicopters[h].home_city_id - 1, t.drops);
+}
+
+void AlnsSearch::refreshHeliDistance(int h) {
+    double total = 0.0;
+    for (const auto& t : current_.plans[h]) total += t.distance;
+    current_.heli_distance[h] = total;
+}
+
+void AlnsSearch::touchHeli(int h) {
+    if (heli_journal_stamp_[h] == journal_id_) return;
+    heli_journal_stamp_[h] = journal_id_;
+    journal_.helis.push_back(h);
+    journal_.saved_plans.push_back(current_.plans[h]);
+    journal_.saved_distance.push_back(current_.heli_distance[h]);
+}
+
+void AlnsSearch::touchVillage(int v) {
+    if (village_journal_stamp_[v] == journal_id_) return;
+    village_journal_stamp_[v] = journal_id_;
+    journal_.villages.push_back(v);
+    journal_.saved_food.push_back(current_.food_delivered[v]);
+    journal_.saved_other.push_back(current_.other_delivered[v]);
+}
+
+void AlnsSearch::refreshUnmet(int v) {
+    if (current_.food_delivered[v] < 9 * problem_.villages[v].population || current_.other_delivered[v] < problem_.villages[v].population) {
+        current_.unmet.insert(v);
+    } else {
+        current_.unmet.remove(v);
+    }
+}
+
+void AlnsSearch::beginIteration() {
+    ++journal_id_;
+    journal_.helis.clear();
+    journal_.saved_plans.clear();
+    journal_.saved_distance.clear();
+    journal_.villages.clear();
+    journal_.saved_food.clear();
+    journal_.saved_other.clear();
+    journal_.value = current_.value;
+    journal_.cost = current_.cost;
+}
+
+void AlnsSearch::rollback() {
+    for (size_t i = 0; i < journal_.helis.size(); ++i) {
+        current_.plans[journal_.helis[i]].swap(journal_.saved_plans[i]);
+        current_.heli_distance[journal_.helis[i]] = journal_.saved_distance[i];
+    }
+    for (size_t i = 0; i < journal_.villages.size(); ++i) {
+        current_.food_delivered[journal_.villages[i]] = journal_.saved_food[i];
+        current_.other_delivered[journal_.villages[i]] = journal_.saved_other[i];
+        refreshUnmet(journal_.villages[i]);
+    }
+    current_.value = journal_.value;
+    current_.cost = journal_.cost;
+}
+
+void AlnsSearch::removeTrip(int h, int t) {
+    touchHeli(h);
+    RouteTrip& trip = current_.plans[h][t];
+    for (const auto& d : trip.drops) {
+        int v = d.village_id - 1;
+        touchVillage(v);
+        current_.food_delivered[v] -= d.dry_food + d.perishable_food;
+        current_.other_delivered[v] -= d.other_supplies;
+        refreshUnmet(v);
+        current_.value -= dropValue(d);
+    }
+    current_.cost -= tripCost(h, trip);
+    current_.plans[h].erase(current_.plans[h].begin() + t);
+    refreshHeliDistance(h);
+}
+
+void AlnsSearch::removeVillages(const vector<int>& villages) {
+    ++stamp_id_;
+    for (int v : villages) stamp_[v] = stamp_id_;
+
+    for (size_t h = 0; h < current_.plans.size(); ++h) {
+        auto& plan = current_.plans[h];
+        bool heli_changed = false;
+        for (int t = static_cast<int>(plan.size()) - 1; t >= 0; --t) {
+            bool hit = false;
+            for (const auto& d : plan[t].drops) {
+                if (stamp_[d.village_id - 1] == stamp_id_) { hit = true; break; }
+            }
+            if (!hit) continue;
+            if (!heli_changed) {
+                touchHeli(h);
+                heli_changed = true;
+            }
+            RouteTrip& trip = plan[t];
+            current_.cost -= tripCost(h, trip);
+            auto keep = trip.drops.begin();
+            for (auto it = trip.drops.begin(); it != trip.drops.end(); ++it) {
+                int v = it->village_id - 1;
+                if (stamp_[v] == stamp_id_) {
+                    touchVillage(v);
+                    current_.food_delivered[v] -= it->dry_food + it->perishable_food;
+                    current_.other_delivered[v] -= it->other_supplies;
+                    refreshUnmet(v);
+                    current_.value -= dropValue(*it);
+                } else {
+                    *keep++ = *it;
+                }
+            }
+            trip.drops.erase(keep, trip.drops.end());
+            if (trip.drops.empty()) {
+                plan.erase(plan.begin() + t);
+            } else {
+                refreshTrip(h, trip);
+                trip.dirty = true;
+                current_.cost += tripCost(h, trip);
+            }
+        }
+        if (heli_changed) refreshHeliDistance(h);
+    }
+}
+
+void AlnsSearch::applyOption(int v, const Option& opt) {
+    touchHeli(opt.heli);
+    touchVillage(v);
+    auto& plan = current_.plans[opt.heli];
+    Drop drop = {problem_.villages[v].id, opt.load.dry, opt.load.perishable, opt.load.other};
+
+    if (opt.trip < 0) {
+        RouteTrip trip;
+        trip.drops.push_back(drop);
+        refreshTrip(opt.heli, trip);
+        trip.dirty = false;
+        current_.cost += tripCost(opt.heli, trip);
+        plan.push_back(move(trip));
+    } else {
+        RouteTrip& trip = plan[opt.trip];
+        if (opt.pos < 0) {
+            for (auto& d : trip.drops) {
+                if (d.village_id - 1 != v) continue;
+                d.dry_food += drop.dry_food;
+                d.perishable_food += drop.perishable_food;
+                d.other_supplies += drop.other_supplies;
+                break;
+            }
+            trip.dry += drop.dry_food;
+            trip.perishable += drop.perishable_food;
+            trip.other += drop.other_supplies;
+        } else {
+            current_.cost -= tripCost(opt.heli, trip);
+            trip.drops.insert(trip.drops.begin() + opt.pos, drop);
+            refreshTrip(opt.heli, trip);
+            trip.dirty = true;
+            current_.cost += tripCost(opt.heli, trip);
+        }
+    }
+
+    current_.food_delivered[v] += drop.dry_food + drop.perishable_food;
+    current_.other_delivered[v] += drop.other_supplies;
+    refreshUnmet(v);
+    current_.value += opt.load.value;
+    refreshHeliDistance(opt.heli);
+}
+
+// --- DESTROY ---
+
+int AlnsSearch::pickServedVillage() {
+    const int H = static_cast<int>(current_.plans.size());
+    if (H == 0) return -1;
+    for (int attempt = 0; attempt < 4 * H + 8; ++attempt) {
+        const auto& plan = current_.plans[gen_() % H];
+        if (plan.empty()) continue;
+        const auto& trip = plan[gen_() % plan.size()];
+        return trip.drops[gen_() % trip.drops.size()].village_id - 1;
+    }
+    return -1;
+}
+
+void AlnsSearch::destroy(DestroyOp op, int q, vector<int>& removed) {
+    removed.clear();
+    ++stamp_id_;
+    auto mark = [&](int v) {
+        if (v < 0 || stamp_[v] == stamp_id_) return false;
+        stamp_[v] = stamp_id_;
+        removed.push_back(v);
+        return true;
+    };
+
+    if (op == RANDOM_REMOVAL) {
+        for (int attempt = 0; attempt < 4 * q && static_cast<int>(removed.size()) < q; ++attempt) {
+            mark(pickServedVillage());
+        }
+        removeVillages(removed);
+    } else if (op == CLUSTER_REMOVAL) {
+        int seed = pickServedVillage();
+        if (seed < 0) return;
+        auto served = [&](int v) { return current_.food_delivered[v] > 0 || current_.other_delivered[v] > 0; };
+        if (neighbors_ && neighbors_->villageListSize() > 0) {
+            mark(seed);
+            for (const int* it = neighbors_->villageBegin(seed); it != neighbors_->villageEnd(seed); ++it) {
+                if (static_cast<int>(removed.size()) >= q) break;
+                if (served(*it)) mark(*it);
+            }
+        }
+        if (static_cast<int>(removed.size()) < q) {
+            vector<int> neighbours;
+            grid_.nearest(problem_.villages[seed].coords, 3 * q + 1, neighbours);
+            for (int v : neighbours) {
+                if (static_cast<int>(removed.size()) >= q) break;
+                if (served(v)) mark(v);
+            }
+        }
+        removeVillages(removed);
+    } else {
+        // Worst trips by net contribution, picked with a bias towards the worst.
+        vector<pair<double, pair<int, int>>> ranked;
+        for (size_t h = 0; h < current_.plans.size(); ++h) {
+            for (size_t t = 0; t < current_.plans[h].size(); ++t) {
+                const RouteTrip& trip = current_.plans[h][t];
+                double value = 0.0;
+                for (const auto& d : trip.drops) value += dropValue(d);
+                ranked.push_back({value - tripCost(h, trip), {static_cast<int>(h), static_cast<int>(t)}});
+            }
+        }
+        if (ranked.empty()) return;
+        sort(ranked.begin(), ranked.end());
+
+        uniform_real_distribution<> u(0.0, 1.0);
+        vector<pair<int, int>> chosen;
+        vector<char> taken(ranked.size(), 0);
+        int villages = 0;
+        for (int attempt = 0; attempt < 4 * q && villages < q; ++attempt) {
+            size_t idx = static_cast<size_t>(pow(u(gen_), kWorstTripBias) * ranked.size());
+            if (idx >= ranked.size() || taken[idx]) continue;
+            taken[idx] = 1;
+            chosen.push_back(ranked[idx].second);
+            const auto& trip = current_.plans[ranked[idx].second.first][ranked[idx].second.second];
+            for (const auto& d : trip.drops) {
+                if (mark(d.village_id - 1)) ++villages;
+            }
+        }
+        // Remove from the back of each plan so earlier trip indices stay valid.
+        sort(chosen.begin(), chosen.end(), [](const pair<int, int>& a, const pair<int, int>& b) {
+            return a.first != b.first ? a.first < b.first : a.second > b.second;
+        });
+        for (const auto& ht : chosen) removeTrip(ht.first, ht.second);
+    }
+}
+
+// --- REPAIR ---
+
+bool AlnsSearch::optionForTrip(int v, int h, int t, int food_need, int other_need, Option& out) const {
+    const auto& helicopter = problem_.helicopters[h];
+    const RouteTrip& trip = current_.plans[h][t];
+    double room = helicopter.weight_capacity - tripWeight(trip);
+    if (room <= kEps) return false;
+
+    const int city = helicopter.home_city_id - 1;
+    const int n = static_cast<int>(trip.drops.size());
+    double best_delta = numeric_limits<double>::max();
+    int best_pos = 0;
+    for (int p = 0; p <= n; ++p) {
+        int prev = p == 0 ? -1 : trip.drops[p - 1].village_id - 1;
+        int next = p == n ? -1 : trip.drops[p].village_id - 1;
+        if (prev == v || next == v) {
+            best_delta = 0.0;
+            best_pos = -1; // already visited: top up in place
+            break;
+        }
+        double d_in = prev < 0 ? dist_.cityToVillage(city, v) : dist_.villageToVillage(prev, v);
+        double d_out = next < 0 ? dist_.cityToVillage(city, v) : dist_.villageToVillage(v, next);
+        double d_skip = (prev < 0 && next < 0) ? 0.0 : prev < 0 ? dist_.cityToVillage(city, next) : next < 0 ? dist_.cityToVillage(city, prev) : dist_.villageToVillage(prev, next);
+        double delta = d_in + d_out - d_skip;
+        if (delta < best_delta) {
+            best_delta = delta;
+            best_pos = p;
+        }
+    }
+    if (best_pos >= 0) {
+        if (trip.distance + best_delta > helicopter.distance_capacity) return false;
+        if (current_.heli_distance[h] + best_delta > problem_.d_max) return false;
+    }
+
+    Load load = bestLoad(room, food_need, other_need);
+    if (load.empty()) return false;
+    out = {load.value - helicopter.alpha * best_delta, h, t, best_pos, load};
+    return out.gain > kEps;
+}
+
+bool AlnsSearch::optionForNewTrip(int v, int h, int food_need, int other_need, Option& out) const {
+    const auto& helicopter = problem_.helicopters[h];
+    double d = dist_.cityToVillage(helicopter.home_city_id - 1, v);
+    double trip_distance = d + d;
+    if (trip_distance > helicopter.distance_capacity) return false;
+    if (current_.heli_distance[h] + trip_distance > problem_.d_max) return false;
+    Load load = bestLoad(helicopter.weight_capacity, food_need, other_need);
+    if (load.empty()) return false;
+    out = {load.value - helicopter.fixed_cost - helicopter.alpha * trip_distance, h, -1, 0, load};
+    return out.gain > kEps;
+}
+
+void AlnsSearch::collectOptions(int v, int k, vector<Option>& out) const {
+    out.clear();
+    int food_need = 9 * problem_.villages[v].population - current_.food_delivered[v];
+    int other_need = problem_.villages[v].population - current_.other_delivered[v];
+    if (food_need <= 0 && other_need <= 0) return;
+
+    Option opt;
+    for (size_t h = 0; h < current_.plans.size(); ++h) {
+        const auto& helicopter = problem_.helicopters[h];
+        // Any tour through v from home is at least twice the home->v distance.
+        if (2.0 * dist_.cityToVillage(helicopter.home_city_id - 1, v) > helicopter.distance_capacity) continue;
+        for (size_t t = 0; t < current_.plans[h].size(); ++t) {
+            if (optionForTrip(v, h, t, food_need, other_need, opt)) out.push_back(opt);
+        }
+        if (optionForNewTrip(v, h, food_need, other_need, opt)) out.push_back(opt);
+    }
+    auto by_gain = [](const Option& a, const Option& b) { return a.gain > b.gain; };
+    if (static_cast<int>(out.size()) > k) {
+        partial_sort(out.begin(), out.begin() + k, out.end(), by_gain);
+        out.resize(k);
+    } else {
+        sort(out.begin(), out.end(), by_gain);
+    }
+}
+
+void AlnsSearch::repair(RepairOp op, vector<int>& pool) {
+    const int k = op == GREEDY_INSERTION ? 1 : (op == REGRET2_INSERTION ? 2 : 3);
+    vector<vector<Option>> options(pool.size());
+    for (size_t i = 0; i < pool.size(); ++i) collectOptions(pool[i], k, options[i]);
+
+    Option extra;
+    while (true) {
+        int chosen = -1;
+        double chosen_key = -numeric_limits<double>::max(), chosen_gain = 0.0;
+        for (size_t i = 0; i < pool.size(); ++i) {
+            if (options[i].empty()) continue;
+            double key = options[i][0].gain;
+            if (k > 1) {
+                key = 0.0;
+                for (int j = 1; j < k; ++j) {
+                    key += options[i][0].gain - (j < static_cast<int>(options[i].size()) ? options[i][j].gain : 0.0);
+                }
+            }
+            if (key > chosen_key || (key == chosen_key && options[i][0].gain > chosen_gain)) {
+                chosen = static_cast<int>(i);
+                chosen_key = key;
+                chosen_gain = options[i][0].gain;
+            }
+        }
+        if (chosen < 0) break;
+
+        Option applied = options[chosen][0];
+        applyOption(pool[chosen], applied);
+        int trip = applied.trip < 0 ? static_cast<int>(current_.plans[applied.heli].size()) - 1 : applied.trip;
+
+        // Only options on the changed helicopter can have become stale; the changed trip may offer new ones.
+        for (size_t i = 0; i < pool.size(); ++i) {
+            bool stale = static_cast<int>(i) == chosen;
+            for (const auto& o : options[i]) stale = stale || o.heli == applied.heli;
+            if (stale) {
+                collectOptions(pool[i], k, options[i]);
+                continue;
+            }
+            int v = pool[i];
+            int food_need = 9 * problem_.villages[v].population - current_.food_delivered[v];
+            int other_need = problem_.villages[v].population - current_.other_delivered[v];
+            if (optionForTrip(v, applied.heli, trip, food_need, other_need, extra)) {
+                auto& list = options[i];
+                auto it = find_if(list.begin(), list.end(), [&](const Option& o) { return o.gain < extra.gain; });
+                list.insert(it, extra);
+                if (static_cast<int>(list.size()) > k) list.pop_back();
+            }
+        }
+    }
+}
+
+void AlnsSearch::improveDirtyTrips() {
+    for (int h : journal_.helis) {
+        int city = problem_.helicopters[h].home_city_id - 1;
+        bool changed = false;
+        for (auto& trip : current_.plans[h]) {
+            if (!trip.dirty) continue;
+            trip.dirty = false;
+            current_.cost -= tripCost(h, trip);
+            trip.distance = improveTripRoute(dist_, city, trip.drops);
+            current_.cost += tripCost(h, trip);
+            changed = true;
+        }
+        if (changed) refreshHeliDistance(h);
+    }
+}
+
+// --- SEARCH LOOP ---
+
+int AlnsSearch::selectOperator(const vector<double>& weights) {
+    double total = 0.0;
+    for (double w : weights) total += w;
+    double r = uniform_real_distribution<>(0.0, total)(gen_);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        if (r < weights[i]) return static_cast<int>(i);
+        r -= weights[i];
+    }
+    return static_cast<int>(weights.size()) - 1;
+}
+
+void AlnsSearch::updateWeights() {
+    auto update = [](vector<double>& weights, vector<double>& scores, vector<int>& uses) {
+        for (size_t i = 0; i < weights.size(); ++i) {
+            if (uses[i] > 0) weights[i] = (1.0 - kReaction) * weights[i] + kReaction * scores[i] / uses[i];
+            weights[i] = max(kMinWeight, weights[i]);
+            scores[i] = 0.0;
+            uses[i] = 0;
+        }
+    };
+    update(destroy_weights_, destroy_scores_, destroy_uses_);
+    update(repair_weights_, repair_scores_, repair_uses_);
+}
+
+void AlnsSearch::setSolution(const Solution& solution) {
+    const size_t H = problem_.helicopters.size(), V = problem_.villages.size();
+    current_ = State();
+    current_.plans.assign(H, {});
+    current_.heli_distance.assign(H, 0.0);
+    current_.food_delivered.assign(V, 0);
+    current_.other_delivered.assign(V, 0);
+    current_.unmet = ActiveSet(static_cast<int>(V));
+
+    const bool perishable_first = problem_.packages[PER].value >= problem_.packages[DRY].value;
+    for (const auto& plan : solution) {
+        int h = plan.helicopter_id - 1;
+        for (const auto& in_trip : plan.trips) {
+            RouteTrip trip;
+            for (const auto& in_drop : in_trip.drops) {
+                int v = in_drop.village_id - 1;
+                // Keep only what the village still needs, most valuable food first.
+                int food_room = 9 * problem_.villages[v].population - current_.food_delivered[v];
+                int other_room = problem_.villages[v].population - current_.other_delivered[v];
+                Drop d = in_drop;
+                if (perishable_first) {
+                    d.perishable_food = max(0, min(d.perishable_food, food_room));
+                    d.dry_food = max(0, min(d.dry_food, food_room - d.perishable_food));
+                } else {
+                    d.dry_food = max(0, min(d.dry_food, food_room));
+                    d.perishable_food = max(0, min(d.perishable_food, food_room - d.dry_food));
+                }
+                d.other_supplies = max(0, min(d.other_supplies, other_room));
+                if (d.dry_food + d.perishable_food + d.other_supplies == 0) continue;
+
+                auto same = find_if(trip.drops.begin(), trip.drops.end(), [&](const Drop& x) { return x.village_id == d.village_id; });
+                if (same != trip.drops.end()) {
+                    same->dry_food += d.dry_food;
+                    same->perishable_food += d.perishable_food;
+                    same->other_supplies += d.other_supplies;
+                } else {
+                    trip.drops.push_back(d);
+                }
+                current_.food_delivered[v] += d.dry_food + d.perishable_food;
+                current_.other_delivered[v] += d.other_supplies;
+                current_.value += dropValue(d);
+            }
+            if (trip.drops.empty()) continue;
+            refreshTrip(h, trip);
+            current_.cost += tripCost(h, trip);
+            current_.plans[h].push_back(move(trip));
+        }
+        refreshHeliDistance(h);
+    }
+    for (size_t v = 0; v < V; ++v) refreshUnmet(static_cast<int>(v));
+    best_ = current_;
+    temperature0_ = max(1.0, kInitialTemperatureFraction * fabs(current_.value - current_.cost));
+    since_best_ = 0;
+}
+
+void AlnsSearch::run(const Deadline& deadline, long max_iterations, const ImproveCallback& on_improve) {
+    if (current_.plans.empty()) setSolution(Solution());
+
+    const auto run_start = has_horizon_ ? horizon_start_ : Deadline::Clock::now();
+    const double run_span = max(1e-9, chrono::duration<double>((has_horizon_ ? horizon_end_ : deadline.end()) - run_start).count());
+    uniform_real_distribution<> u(0.0, 1.0);
+    vector<int> removed, pool;
+
+    for (long it = 0; max_iterations == 0 || it < max_iterations; ++it) {
+        if (deadline.expired()) break;
+        double progress = max_iterations > 0 ? double(it) / max_iterations
+                                             : chrono::duration<double>(Deadline::Clock::now() - run_start).count() / run_span;
+        double temperature = temperature0_ * pow(kFinalTemperatureRatio, min(1.0, progress));
+
+        beginIteration();
+        int served = 0;
+        for (const auto& plan : current_.plans) {
+            for (const auto& trip : plan) served += static_cast<int>(trip.drops.size());
+        }
+        int q_max = max(kMinRemoval, min(kMaxRemoval, static_cast<int>(served * kMaxRemovalFraction)));
+        int q = uniform_int_distribution<>(min(kMinRemoval, q_max), q_max)(gen_);
+
+        DestroyOp d_op = static_cast<DestroyOp>(selectOperator(destroy_weights_));
+        RepairOp r_op = static_cast<RepairOp>(selectOperator(repair_weights_));
+        destroy(d_op, q, removed);
+
+        // Repair the removed villages plus a sample of other villages with unmet demand.
+        pool = removed;
+        ++stamp_id_;
+        for (int v : pool) stamp_[v] = stamp_id_;
+        const ActiveSet& unmet = current_.unmet;
+        for (int s = 0; s < q && !unmet.empty(); ++s) {
+            int v = unmet[gen_() % unmet.size()];
+            if (stamp_[v] == stamp_id_) continue;
+            stamp_[v] = stamp_id_;
+            pool.push_back(v);
+        }
+        repair(r_op, pool);
+        improveDirtyTrips();
+
+        double candidate = current_.value - current_.cost;
+        double previous = journal_.value - journal_.cost;
+        double score = 0.0;
+        if (candidate > best_.value - best_.cost + kEps) {
+            score = kScoreNewBest;
+            best_ = current_;
+            since_best_ = 0;
+            if (on_improve) {
+                exportState(best_, best_export_);
+                on_improve(best_export_);
+            }
+        } else if (candidate > previous + kEps) {
+            score = kScoreBetter;
+        } else if (u(gen_) < exp((candidate - previous) / temperature)) {
+            score = kScoreAccepted;
+        } else {
+            rollback();
+        }
+
+        destroy_scores_[d_op] += score;
+        repair_scores_[r_op] += score;
+        destroy_uses_[d_op]++;
+        repair_uses_[r_op]++;
+        ++iterations_;
+        if (iterations_ % kSegmentLength == 0) updateWeights();
+
+        if (++since_best_ >= kRestartAfter) {
+            current_ = best_;
+            since_best_ = 0;
+        }
+    }
+}
+
+void AlnsSearch::exportState(const State& state, FlatSolution& out) const {
+    out.clear();
+    for (size_t h = 0; h < state.plans.size(); ++h) {
+        if (state.plans[h].empty()) continue;
+        out.addPlan(problem_.helicopters[h].id);
+        for (const auto& route : state.plans[h]) {
+            out.addTrip(route.dry, route.perishable, route.other, route.drops.data(), route.drops.data() + route.drops.size());
+        }
+    }
+}
+
+Solution AlnsSearch::bestSolution() const {
+    FlatSolution best;
+    exportState(best_, best);
+    return best.toSolution();
+}
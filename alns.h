@@ -0,0 +1,157 @@
+#ifndef ALNS_H
+#define ALNS_H
+
+#include <functional>
+#include <random>
+#include <vector>
+#include "structures.h"
+#include "distance_cache.h"
+#include "spatial_index.h"
+#include "neighbor_lists.h"
+#include "active_set.h"
+#include "deadline.h"
+#include "flat_solution.h"
+
+/**
+ * @brief Adaptive large neighbourhood search over complete plans.
+ *
+ * Each iteration removes part of the current solution with one destroy operator (random
+ * villages, worst trips, or a geographic cluster of villages) and rebuilds it with one repair
+ * operator (greedy or regret-k insertion). Repairs may place villages on any helicopter, in any
+ * existing trip or in a new trip from that helicopter's home city, and may top up villages
+ * already visited. Operators are drawn by roulette wheel with weights that adapt to how often
+ * they produce new bests, improvements and accepted moves; candidates are accepted by simulated
+ * annealing. Drops never exceed a village's remaining need, so every drop counts at full value.
+ */
+class AlnsSearch {
+public:
+    using ImproveCallback = std::function<void(const FlatSolution&)>;
+
+    /**
+     * @param neighbors If given and not empty, cluster removal walks the seed village's list and
+     * queries the grid only when the list holds too few served villages.
+     */
+    AlnsSearch(const ProblemData& problem, const DistanceCache& dist, const VillageGrid& grid, unsigned seed,
+               const NeighborLists* neighbors = nullptr);
+
+    /**
+     * @brief Installs the starting solution (drops that would oversupply a village are trimmed).
+     */
+    void setSolution(const Solution& solution);
+
+    /**
+     * @brief Iterates until the deadline passes or max_iterations more iterations have run (0 = no cap).
+     * on_improve is called with every new best solution, in a buffer the search reuses: copy
+     * what must outlive the call.
+     */
+    void run(const Deadline& deadline, long max_iterations = 0, const ImproveCallback& on_improve = nullptr);
+
+    /**
+     * @brief Cools over [start, end] instead of over each run, for a search that is run in slices.
+     * Only time-limited runs (max_iterations == 0) use it.
+     */
+    void setHorizon(Deadline::Clock::time_point start, Deadline::Clock::time_point end) {
+        horizon_start_ = start;
+        horizon_end_ = end;
+        has_horizon_ = true;
+    }
+
+    Solution bestSolution() const;
+    double bestObjective() const { return best_.value - best_.cost; }
+    long iterations() const { return iterations_; }
+
+private:
+    struct RouteTrip {
+        vector<Drop> drops;
+        double distance = 0.0;
+        int dry = 0, perishable = 0, other = 0;
+        bool dirty = false;
+    };
+
+    struct State {
+        vector<vector<RouteTrip>> plans;   // by helicopter index
+        vector<double> heli_distance;
+        vector<int> food_delivered, other_delivered; // by village index
+        ActiveSet unmet;                              // villages with demand left
+        double value = 0.0, cost = 0.0;
+    };
+
+    struct Load {
+        int dry = 0, perishable = 0, other = 0;
+        double value = 0.0;
+        bool empty() const { return dry + perishable + other == 0; }
+    };
+
+    struct Option {
+        double gain;
+        int heli, trip, pos; // trip == -1: new trip; pos == -1: top up an existing drop
+        Load load;
+    };
+
+    enum DestroyOp { RANDOM_REMOVAL, WORST_TRIP_REMOVAL, CLUSTER_REMOVAL, NUM_DESTROY };
+    enum RepairOp { GREEDY_INSERTION, REGRET2_INSERTION, REGRET3_INSERTION, NUM_REPAIR };
+
+    // Journal of the current iteration, so a rejected candidate is undone in time proportional to what it touched.
+    struct Journal {
+        vector<int> helis;
+        vector<vector<RouteTrip>> saved_plans;
+        vector<double> saved_distance;
+        vector<int> villages;
+        vector<int> saved_food, saved_other;
+        double value = 0.0, cost = 0.0;
+    };
+
+    void beginIteration();
+    void touchHeli(int h);
+    void touchVillage(int v);
+    void refreshUnmet(int v);
+    void rollback();
+
+    Load bestLoad(double capacity, int food_need, int other_need) const;
+    double tripWeight(const RouteTrip& t) const;
+    double tripCost(int h, const RouteTrip& t) const;
+    double dropValue(const Drop& d) const;
+    void refreshTrip(int h, RouteTrip& t);
+    void refreshHeliDistance(int h);
+    void removeTrip(int h, int t);
+    void removeVillages(const vector<int>& villages);
+    void applyOption(int v, const Option& opt);
+
+    int pickServedVillage();
+    void destroy(DestroyOp op, int q, vector<int>& removed);
+    bool optionForTrip(int v, int h, int t, int food_need, int other_need, Option& out) const;
+    bool optionForNewTrip(int v, int h, int food_need, int other_need, Option& out) const;
+    void collectOptions(int v, int k, vector<Option>& out) const;
+    void repair(RepairOp op, vector<int>& pool);
+    void improveDirtyTrips();
+
+    int selectOperator(const vector<double>& weights);
+    void updateWeights();
+    void exportState(const State& state, FlatSolution& out) const;
+
+    const ProblemData& problem_;
+    const DistanceCache& dist_;
+    const VillageGrid& grid_;
+    const NeighborLists* neighbors_;
+    mt19937 gen_;
+
+    State current_, best_;
+    FlatSolution best_export_;
+    Journal journal_;
+    vector<int> stamp_;
+    int stamp_id_ = 0;
+    vector<long> heli_journal_stamp_, village_journal_stamp_;
+    long journal_id_ = 0;
+    long iterations_ = 0;
+    long since_best_ = 0;
+    double temperature0_ = 1.0;
+    bool has_horizon_ = false;
+    Deadline::Clock::time_point horizon_start_, horizon_end_;
+
+    vector<double> destroy_weights_, repair_weights_;
+    vector<double> destroy_scores_, repair_scores_;
+    vector<int> destroy_uses_, repair_uses_;
+    int order_[3]; // package types by decreasing value per weight
+};
+
+#endif // ALNS_H
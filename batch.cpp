@@ -0,0 +1,185 @@
+#include "batch.h"
+#include "io_handler.h"
+#include "scoring.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+string defaultOutput(const fs::path& input, const string& output_dir) {
+    return (fs::path(output_dir) / input.stem()).string() + ".out";
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Parses, solves, writes and scores one instance, following main's single-run flow.
+ */
+void solveEntry(const BatchEntry& entry, const BatchOptions& options, SolverWorkspace& workspace, BatchResult& result) {
+    result.entry = entry;
+    try {
+        auto parse_start = chrono::steady_clock::now();
+        ProblemData problem = readInputData(entry.input);
+        result.parse_seconds = secondsSince(parse_start);
+        result.villages = static_cast<int>(problem.villages.size());
+        result.time_limit_seconds = problem.time_limit_minutes * 60.0;
+
+        auto allowed_duration = chrono::milliseconds(long(problem.time_limit_minutes * 60 * 1000));
+        auto start_time = chrono::steady_clock::now();
+        auto deadline = start_time + allowed_duration;
+
+        SolverOptions solver = options.solver;
+        SolverStats stats;
+        Telemetry telemetry;
+        solver.stats = &stats;
+        solver.telemetry = &telemetry;
+        solver.workspace = &workspace;
+        Solution solution = solve(problem, solver);
+
+        auto end_time = chrono::steady_clock::now();
+        result.solve_seconds = chrono::duration<double>(end_time - start_time).count();
+        result.gap = stats.optimality_gap;
+        result.stopped_at_gap = stats.stopped_at_gap;
+        if (end_time > deadline) {
+            result.status = "time_limit_exceeded";
+            return;
+        }
+
+        writeOutputData(entry.output, solution, true);
+        if (Telemetry::kEnabled) {
+            telemetry.writeJson(entry.output + ".stats.json");
+        }
+
+        // Score what the grader will read: the file just written, against the tables solve() left in the workspace.
+        SolutionScorer scorer(problem, workspace.dist);
+        result.score = scorer.score(readSolutionData(entry.output)).score();
+        result.status = "ok";
+    } catch (const exception& e) {
+        result.status = "error";
+        result.message = e.what();
+    }
+}
+
+} // namespace
+
+vector<BatchEntry> listBatchEntries(const string& source, const string& output_dir) {
+    vector<BatchEntry> entries;
+    if (fs::is_directory(source)) {
+        vector<fs::path> inputs;
+        for (const auto& item : fs::directory_iterator(source)) {
+            if (item.is_regular_file() && item.path().extension() == ".txt") inputs.push_back(item.path());
+        }
+        sort(inputs.begin(), inputs.end());
+        for (const auto& input : inputs) entries.push_back({input.string(), defaultOutput(input, output_dir)});
+        return entries;
+    }
+
+    ifstream manifest(source);
+    if (!manifest.is_open()) {
+        throw runtime_error("Error: Could not open batch manifest or directory " + source);
+    }
+    const fs::path base = fs::path(source).parent_path();
+    string line;
+    int line_num = 0;
+    while (getline(manifest, line)) {
+        line_num++;
+        stringstream ss(line);
+        string input, output, extra;
+        if (!(ss >> input) || input[0] == '#') continue;
+        ss >> output;
+        if (ss >> extra) {
+            throw runtime_error("Error (Line " + to_string(line_num) + "): Expected \"<input> [<output>]\" in manifest " + source);
+        }
+        fs::path input_path = base / input;
+        entries.push_back({input_path.string(), output.empty() ? defaultOutput(input_path, output_dir) : (base / output).string()});
+    }
+    return entries;
+}
+
+vector<BatchResult> runBatch(const vector<BatchEntry>& entries, const BatchOptions& options) {
+    vector<BatchResult> results(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) results[i].entry = entries[i];
+    if (entries.empty()) return results;
+
+    int hardware = max(1u, thread::hardware_concurrency());
+    int jobs = options.jobs > 0 ? options.jobs : max(1, hardware / max(1, options.solver.num_threads > 0 ? options.solver.num_threads : hardware));
+    jobs = min(jobs, static_cast<int>(entries.size()));
+
+    atomic<size_t> next_entry(0);
+    atomic<size_t> finished(0);
+    mutex log_mutex;
+
+    // Each job owns one workspace for its whole life, so its buffers carry over from instance to instance.
+    auto job = [&]() {
+        SolverWorkspace workspace;
+        while (true) {
+            if (options.solver.cancel && options.solver.cancel->cancelled()) break;
+            size_t idx = next_entry.fetch_add(1);
+            if (idx >= entries.size()) break;
+            solveEntry(entries[idx], options, workspace, results[idx]);
+
+            lock_guard<mutex> lock(log_mutex);
+            const BatchResult& r = results[idx];
+            cout << "[" << ++finished << "/" << entries.size() << "] " << r.entry.input << ": " << r.status;
+            if (r.status == "ok") cout << ", score " << r.score;
+            if (!r.message.empty()) cout << " (" << r.message << ")";
+            cout << endl;
+        }
+    };
+
+    if (jobs == 1) {
+        job();
+    } else {
+        vector<thread> workers;
+        workers.reserve(jobs);
+        for (int j = 0; j < jobs; ++j) workers.emplace_back(job);
+        for (auto& w : workers) w.join();
+    }
+    return results;
+}
+
+void writeBatchSummary(const string& filename, const vector<BatchResult>& results) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Error: Could not open summary file " + filename);
+    }
+    file << setprecision(15);
+    file << "input\toutput\tstatus\tvillages\ttime_limit_s\tparse_s\tsolve_s\tscore\tgap\tstopped_at_gap\tmessage\n";
+    for (const auto& r : results) {
+        file << r.entry.input << '\t' << r.entry.output << '\t' << r.status << '\t' << r.villages << '\t'
+             << r.time_limit_seconds << '\t' << r.parse_seconds << '\t' << r.solve_seconds << '\t' << r.score << '\t'
+             << r.gap << '\t' << r.stopped_at_gap << '\t' << r.message << '\n';
+    }
+}
+
+void printBatchTable(ostream& out, const vector<BatchResult>& results) {
+    size_t name_width = 8;
+    for (const auto& r : results) name_width = max(name_width, r.entry.input.size());
+
+    out << left << setw(name_width) << "instance" << "  " << setw(20) << "status" << right
+        << setw(10) << "villages" << setw(10) << "parse_s" << setw(10) << "solve_s" << setw(18) << "score" << setw(10) << "gap_%" << "\n";
+    double total_score = 0.0;
+    int solved = 0;
+    for (const auto& r : results) {
+        out << left << setw(name_width) << r.entry.input << "  " << setw(20) << r.status << right
+            << setw(10) << r.villages << fixed << setprecision(3) << setw(10) << r.parse_seconds << setw(10) << r.solve_seconds
+            << setprecision(2) << setw(18) << r.score << setw(10) << 100.0 * r.gap << defaultfloat << "\n";
+        if (r.status == "ok" && r.score > 0) total_score += r.score;
+        if (r.status == "ok") solved++;
+    }
+    out << solved << "/" << results.size() << " instances solved, total score " << fixed << setprecision(2) << total_score << defaultfloat << "\n";
+}
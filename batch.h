@@ -0,0 +1,73 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "solver.h"
+
+/**
+ * @brief One instance of a batch: where to read it and where to write its solution.
+ */
+struct BatchEntry {
+    std::string input;
+    std::string output;
+};
+
+/**
+ * @brief Outcome of one instance. status is "ok", "time_limit_exceeded", "cancelled" or "error".
+ */
+struct BatchResult {
+    BatchEntry entry;
+    std::string status = "cancelled";
+    std::string message;
+    int villages = 0;
+    double time_limit_seconds = 0.0;
+    double parse_seconds = 0.0;
+    double solve_seconds = 0.0;
+    double score = 0.0;  // As the checker scores the written file (-1 if it breaks a constraint).
+    double gap = 0.0;    // Optimality gap of the solve's best plan (see SolverStats::optimality_gap).
+    bool stopped_at_gap = false; // The solve ended before its time limit, within the gap tolerance.
+};
+
+/**
+ * @brief Settings of a batch run.
+ */
+struct BatchOptions {
+    int jobs = 0;          // Instances solved at once; 0 divides the hardware threads by solver.num_threads.
+    SolverOptions solver;  // Settings for every solve; stats, telemetry and workspace are managed per job.
+};
+
+/**
+ * @brief Lists the instances of a batch source.
+ *
+ * A directory contributes every *.txt file in it, in name order, each solved into
+ * output_dir/<name>.out. Any other path is read as a manifest with one instance per line:
+ * "<input> [<output>]". Blank lines and lines starting with '#' are skipped, relative paths are
+ * taken relative to the manifest's directory, and a missing output defaults as for directories.
+ */
+std::vector<BatchEntry> listBatchEntries(const std::string& source, const std::string& output_dir);
+
+/**
+ * @brief Solves every entry on a pool of job workers, each with its own reusable workspace.
+ *
+ * Each instance gets its own time limit from its time_limit_minutes, measured from the end of
+ * parsing as in a single run, and a solve that reaches the gap tolerance hands its job on to the
+ * next instance early. Solutions that finish in time are written and then scored by
+ * reading the file back through the shared checker library. A failing instance is recorded and
+ * does not stop the batch; a cancellation (solver.cancel) stops it from starting new instances.
+ * @return One result per entry, in entry order.
+ */
+std::vector<BatchResult> runBatch(const std::vector<BatchEntry>& entries, const BatchOptions& options);
+
+/**
+ * @brief Writes the results as a tab-separated table with a header row.
+ */
+void writeBatchSummary(const std::string& filename, const std::vector<BatchResult>& results);
+
+/**
+ * @brief Prints the results as an aligned table followed by totals.
+ */
+void printBatchTable(std::ostream& out, const std::vector<BatchResult>& results);
+
+#endif // BATCH_H
@@ -0,0 +1,80 @@
+#include "checkpoint.h"
+#include "io_handler.h"
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+CheckpointWriter::CheckpointWriter(const string& path, Prepare prepare, chrono::milliseconds min_interval)
+    : path_(path), prepare_(move(prepare)), min_interval_(min_interval) {
+    thread_ = thread(&CheckpointWriter::loop, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    finish();
+}
+
+void CheckpointWriter::publish(FlatSolution& solution) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (stopping_) return;
+        pending_.swap(solution);
+        has_pending_ = true;
+    }
+    wake_.notify_one();
+}
+
+void CheckpointWriter::finish() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+long CheckpointWriter::writes() const {
+    lock_guard<mutex> lock(mutex_);
+    return writes_;
+}
+
+bool CheckpointWriter::lastWriteOk() const {
+    lock_guard<mutex> lock(mutex_);
+    return last_write_ok_;
+}
+
+string CheckpointWriter::lastError() const {
+    lock_guard<mutex> lock(mutex_);
+    return last_error_;
+}
+
+void CheckpointWriter::loop() {
+    auto last_write = chrono::steady_clock::now() - min_interval_;
+    unique_lock<mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [&] { return has_pending_ || stopping_; });
+        // Rate limit while the search runs; once stopping, the last plan goes out at once.
+        if (!stopping_) wake_.wait_until(lock, last_write + min_interval_, [&] { return stopping_; });
+        if (!has_pending_) {
+            if (stopping_) break;
+            continue;
+        }
+
+        writing_.swap(pending_);
+        has_pending_ = false;
+        lock.unlock();
+        string error;
+        try {
+            Solution solution = writing_.toSolution();
+            writeOutputData(path_, prepare_ ? prepare_(solution) : solution, true);
+        } catch (const exception& e) {
+            error = e.what();
+            cerr << "Warning: checkpoint not written: " << error << endl;
+        }
+        last_write = chrono::steady_clock::now();
+        lock.lock();
+        writes_++;
+        last_write_ok_ = error.empty();
+        last_error_ = error;
+    }
+}
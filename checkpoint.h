@@ -0,0 +1,74 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "structures.h"
+#include "flat_solution.h"
+
+/**
+ * @brief Background writer that keeps the best solution so far on disk while the search runs.
+ *
+ * publish() only hands the solution over and returns; a dedicated thread prepares it (e.g.
+ * validates it) and writes it to the target path with an atomic replace, so the file always holds
+ * a complete plan. Solutions published faster than min_interval are coalesced: only the newest
+ * pending one is written. finish() writes whatever is still pending and stops the thread.
+ * A failed write is logged as a warning and recorded; lastWriteOk() tells whether the most
+ * recent write reached the file, which after finish() is the last plan published.
+ * publish() swaps the plan in rather than copying it, and the pending plan and the one being
+ * written trade buffers the same way, so publishing is O(1) and does not allocate once the
+ * buffers have grown to the size of a plan.
+ */
+class CheckpointWriter {
+public:
+    using Prepare = std::function<Solution(const Solution&)>;
+
+    CheckpointWriter(const std::string& path, Prepare prepare,
+                     std::chrono::milliseconds min_interval = std::chrono::milliseconds(100));
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /**
+     * @brief Takes solution by swapping: on return it holds the buffers of an older plan, free to reuse.
+     */
+    void publish(FlatSolution& solution);
+    void finish();
+
+    long writes() const;
+
+    /**
+     * @brief True if the most recent write succeeded; false if it failed or nothing was written yet.
+     */
+    bool lastWriteOk() const;
+
+    /**
+     * @brief Why the most recent write failed; empty if it succeeded.
+     */
+    std::string lastError() const;
+
+private:
+    void loop();
+
+    const std::string path_;
+    const Prepare prepare_;
+    const std::chrono::milliseconds min_interval_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    FlatSolution pending_;
+    FlatSolution writing_; // Only touched by the writer thread.
+    bool has_pending_ = false;
+    bool stopping_ = false;
+    long writes_ = 0;
+    bool last_write_ok_ = false;
+    std::string last_error_;
+    std::thread thread_;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,103 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @brief A cancel request that can be raised from another thread or a signal handler.
+ */
+class CancellationToken {
+public:
+    static_assert(std::atomic<bool>::is_always_lock_free, "cancel() must be async-signal-safe");
+
+    void cancel() { requested_.store(true, std::memory_order_relaxed); }
+    void reset() { requested_.store(false, std::memory_order_relaxed); }
+    bool cancelled() const { return requested_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> requested_{false};
+};
+
+/**
+ * @brief Wall-clock deadline shared by all solver threads, optionally tied to an external
+ * CancellationToken or to a parent deadline. Once the clock passes the end (or a cancel arrives)
+ * the result is latched in an atomic flag, so every other thread sees it without reading the
+ * clock again.
+ */
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Deadline(Clock::time_point end, const CancellationToken* external = nullptr)
+        : end_(end), external_(external) {}
+
+    /**
+     * @brief Deadline at end or parent's end, whichever comes first, that also stops as soon as
+     * parent does (including through parent.cancel()). parent must outlive it.
+     */
+    Deadline(Clock::time_point end, const Deadline& parent)
+        : end_(std::min(end, parent.end_)), external_(parent.external_), parent_(&parent) {}
+
+    /**
+     * @brief Deadline at start + safety_percent% of the instance's time limit.
+     */
+    static Deadline fromTimeLimit(double time_limit_minutes, int safety_percent, Clock::time_point start, const CancellationToken* external = nullptr) {
+        auto allowed = std::chrono::milliseconds(long(time_limit_minutes * 60 * 1000));
+        auto safe = allowed * safety_percent / 100;
+        return Deadline(start + safe, external);
+    }
+
+    /**
+     * @brief Reads the clock. True once less than a millisecond remains or a cancel was requested.
+     */
+    bool expired() const {
+        if (stopRequested()) return true;
+        if (std::chrono::duration_cast<std::chrono::milliseconds>(end_ - Clock::now()).count() <= 0) {
+            stop_.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Cheap check of the latched flags and the external token; never reads the clock.
+     */
+    bool stopRequested() const {
+        return stop_.load(std::memory_order_relaxed) || (external_ && external_->cancelled()) || (parent_ && parent_->stopRequested());
+    }
+
+    void cancel() { stop_.store(true, std::memory_order_relaxed); }
+
+    Clock::time_point end() const { return end_; }
+
+private:
+    Clock::time_point end_;
+    const CancellationToken* external_;
+    const Deadline* parent_ = nullptr;
+    mutable std::atomic<bool> stop_{false};
+};
+
+/**
+ * @brief Per-thread amortized poller for hot loops: reads the clock once every `interval`
+ * calls and only checks the latched flags in between.
+ */
+class DeadlinePoller {
+public:
+    explicit DeadlinePoller(const Deadline& deadline, unsigned interval = 256)
+        : deadline_(deadline), interval_(interval), countdown_(interval) {}
+
+    bool expired() {
+        if (--countdown_ != 0) return deadline_.stopRequested();
+        countdown_ = interval_;
+        return deadline_.expired();
+    }
+
+private:
+    const Deadline& deadline_;
+    unsigned interval_;
+    unsigned countdown_;
+};
+
+#endif // DEADLINE_H
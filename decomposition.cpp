@@ -0,0 +1,99 @@
+#include "decomposition.h"
+#include <algorithm>
+
+using namespace std;
+
+Decomposition decomposeByHomeCity(const ProblemData& problem, const DistanceCache& dist) {
+    const int num_cities = static_cast<int>(problem.cities.size());
+    const int num_villages = static_cast<int>(problem.villages.size());
+
+    // Farthest a helicopter of each city can fly out and back on one trip; -1 without helicopters.
+    vector<double> reach(num_cities, -1.0);
+    vector<int> region_of_city(num_cities, -1);
+    Decomposition parts;
+    for (size_t h = 0; h < problem.helicopters.size(); ++h) {
+        const Helicopter& helicopter = problem.helicopters[h];
+        const int c = helicopter.home_city_id - 1;
+        reach[c] = max(reach[c], min(helicopter.distance_capacity, problem.d_max) / 2.0);
+    }
+    for (int c = 0; c < num_cities; ++c) {
+        if (reach[c] < 0.0) continue;
+        region_of_city[c] = static_cast<int>(parts.regions.size());
+        parts.regions.push_back(Region());
+        parts.regions.back().city_idx = c;
+    }
+    for (size_t h = 0; h < problem.helicopters.size(); ++h) {
+        parts.regions[region_of_city[problem.helicopters[h].home_city_id - 1]].helicopters.push_back(static_cast<int>(h));
+    }
+
+    vector<const double*> rows(num_cities);
+    for (int c = 0; c < num_cities; ++c) rows[c] = dist.cityRow(c);
+
+    for (int v = 0; v < num_villages; ++v) {
+        int nearest = -1, reached_by = 0;
+        double nearest_distance = 0.0;
+        for (int c = 0; c < num_cities; ++c) {
+            const double d = rows[c] ? rows[c][v] : dist.cityToVillage(c, v);
+            if (reach[c] < 0.0 || d > reach[c]) continue;
+            ++reached_by;
+            // Equal distances go to the lower city index.
+            if (nearest == -1 || d < nearest_distance) {
+                nearest = c;
+                nearest_distance = d;
+            }
+        }
+        if (nearest == -1) {
+            parts.unreachable++;
+            continue;
+        }
+        parts.regions[region_of_city[nearest]].villages.push_back(v);
+        if (reached_by > 1) parts.boundary.push_back(v);
+    }
+    return parts;
+}
+
+ProblemData regionProblem(const ProblemData& problem, const Region& region) {
+    ProblemData sub;
+    sub.time_limit_minutes = problem.time_limit_minutes;
+    sub.d_max = problem.d_max;
+    sub.packages = problem.packages;
+    sub.cities = {problem.cities[region.city_idx]};
+
+    sub.villages.reserve(region.villages.size());
+    for (size_t i = 0; i < region.villages.size(); ++i) {
+        Village village = problem.villages[region.villages[i]];
+        village.id = static_cast<int>(i) + 1;
+        sub.villages.push_back(village);
+    }
+
+    sub.helicopters.reserve(region.helicopters.size());
+    for (size_t i = 0; i < region.helicopters.size(); ++i) {
+        Helicopter helicopter = problem.helicopters[region.helicopters[i]];
+        helicopter.id = static_cast<int>(i) + 1;
+        helicopter.home_city_id = 1;
+        sub.helicopters.push_back(helicopter);
+    }
+    return sub;
+}
+
+Solution mergeRegionSolutions(const ProblemData& problem, const Decomposition& parts, const vector<Solution>& region_solutions) {
+    vector<HelicopterPlan> by_helicopter(problem.helicopters.size());
+    for (size_t r = 0; r < parts.regions.size(); ++r) {
+        const Region& region = parts.regions[r];
+        for (const auto& region_plan : region_solutions[r]) {
+            const int h = region.helicopters[region_plan.helicopter_id - 1];
+            HelicopterPlan& plan = by_helicopter[h];
+            plan.helicopter_id = problem.helicopters[h].id;
+            for (Trip trip : region_plan.trips) {
+                for (auto& drop : trip.drops) drop.village_id = problem.villages[region.villages[drop.village_id - 1]].id;
+                plan.trips.push_back(move(trip));
+            }
+        }
+    }
+
+    Solution merged;
+    for (auto& plan : by_helicopter) {
+        if (!plan.trips.empty()) merged.push_back(move(plan));
+    }
+    return merged;
+}
@@ -0,0 +1,50 @@
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include <vector>
+#include "structures.h"
+#include "distance_cache.h"
+
+/**
+ * @brief One home city's share of an instance: the villages it serves and the helicopters based there.
+ */
+struct Region {
+    int city_idx = 0;             // 0-based index in ProblemData::cities.
+    std::vector<int> villages;    // 0-based village indices, ascending.
+    std::vector<int> helicopters; // 0-based helicopter indices, ascending.
+};
+
+/**
+ * @brief Partition of an instance into regions, one per city that has helicopters.
+ */
+struct Decomposition {
+    std::vector<Region> regions;  // In city order.
+    std::vector<int> boundary;    // Villages that more than one region's helicopters can reach, ascending.
+    int unreachable = 0;          // Villages no helicopter can reach; they belong to no region.
+};
+
+/**
+ * @brief Assigns every village to the nearest home city with a helicopter that can reach it.
+ *
+ * City c reaches village v if one of c's helicopters can fly there and back within both its trip
+ * distance capacity and DMax, so each region's villages form the part of c's Voronoi cell within
+ * its range, widened by the villages only c can reach. Villages more than one city reaches are
+ * still assigned to the nearest one but are listed in boundary, for the repair pass that follows
+ * the regional solves.
+ */
+Decomposition decomposeByHomeCity(const ProblemData& problem, const DistanceCache& dist);
+
+/**
+ * @brief The region as an instance of its own: its city, its helicopters and its villages,
+ * renumbered from 1 in the region's order. Packages, DMax and the time limit are copied.
+ */
+ProblemData regionProblem(const ProblemData& problem, const Region& region);
+
+/**
+ * @brief Combines the regions' solutions, in the numbering of regionProblem(), into one solution
+ * of the whole instance with plans in helicopter order.
+ * @param region_solutions One solution per region of parts, in the same order.
+ */
+Solution mergeRegionSolutions(const ProblemData& problem, const Decomposition& parts, const std::vector<Solution>& region_solutions);
+
+#endif // DECOMPOSITION_H
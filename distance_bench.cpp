@@ -0,0 +1,92 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "structures.h"
+#include "distance_cache.h"
+
+using namespace std;
+
+/**
+ * @brief Microbenchmark: DistanceCache lookups versus the inline distance() function.
+ *
+ * Mimics the solver's access pattern: for every village, scan all villages from it
+ * (village->village) and from a home city (city->village).
+ * Usage: distance_bench [num_villages] [num_cities] [repetitions]
+ */
+
+static ProblemData makeProblem(int num_villages, int num_cities, unsigned seed) {
+    mt19937 gen(seed);
+    uniform_real_distribution<> coord(0.0, 1000.0);
+    ProblemData data;
+    data.cities.resize(num_cities);
+    for (auto& c : data.cities) c = {coord(gen), coord(gen)};
+    data.villages.resize(num_villages);
+    for (int i = 0; i < num_villages; ++i) {
+        data.villages[i] = {i + 1, {coord(gen), coord(gen)}, 100};
+    }
+    return data;
+}
+
+template <typename F>
+static double timeIt(F&& f, double& checksum) {
+    auto start = chrono::steady_clock::now();
+    checksum = f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int num_villages = argc > 1 ? atoi(argv[1]) : 2000;
+    int num_cities = argc > 2 ? atoi(argv[2]) : 8;
+    int reps = argc > 3 ? atoi(argv[3]) : 5;
+
+    ProblemData data = makeProblem(num_villages, num_cities, 42);
+
+    auto build_start = chrono::steady_clock::now();
+    DistanceCache cache(data);
+    double build_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - build_start).count();
+
+    const char* layout_names[] = {"dense", "triangular", "on-demand"};
+    cout << "villages=" << num_villages << " cities=" << num_cities << " layout=" << layout_names[static_cast<int>(cache.layout())]
+         << " build_ms=" << build_ms << endl;
+
+    double inline_sum = 0, cached_sum = 0;
+    double inline_ms = timeIt([&]() {
+        double sum = 0;
+        for (int r = 0; r < reps; ++r) {
+            for (int a = 0; a < num_villages; ++a) {
+                const Point& home = data.cities[a % num_cities];
+                for (int b = 0; b < num_villages; ++b) {
+                    sum += distance(data.villages[a].coords, data.villages[b].coords) + distance(home, data.villages[b].coords);
+                }
+            }
+        }
+        return sum;
+    }, inline_sum);
+
+    double cached_ms = timeIt([&]() {
+        double sum = 0;
+        for (int r = 0; r < reps; ++r) {
+            for (int a = 0; a < num_villages; ++a) {
+                int home = a % num_cities;
+                for (int b = 0; b < num_villages; ++b) {
+                    sum += cache.villageToVillage(a, b) + cache.cityToVillage(home, b);
+                }
+            }
+        }
+        return sum;
+    }, cached_sum);
+
+    double lookups = 2.0 * reps * num_villages * static_cast<double>(num_villages);
+    cout << "inline distance(): " << inline_ms << " ms (" << lookups / inline_ms / 1e3 << " M lookups/s)" << endl;
+    cout << "DistanceCache    : " << cached_ms << " ms (" << lookups / cached_ms / 1e3 << " M lookups/s)" << endl;
+    cout << "speedup          : " << inline_ms / cached_ms << "x" << endl;
+    if (inline_sum != cached_sum) {
+        cerr << "MISMATCH: checksums differ (" << inline_sum << " vs " << cached_sum << ")" << endl;
+        return 1;
+    }
+    return 0;
+}
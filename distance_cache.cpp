@@ -0,0 +1,82 @@
+#include "distance_cache.h"
+
+using namespace std;
+
+DistanceCache::DistanceCache(const ProblemData& problem, Tables tables) {
+    rebuild(problem, tables);
+}
+
+void DistanceCache::rebuild(const ProblemData& problem, Tables tables) {
+    num_villages_ = problem.villages.size();
+    num_cities_ = problem.cities.size();
+    tables_ = tables;
+    xs_.resize(num_villages_);
+    ys_.resize(num_villages_);
+    for (size_t i = 0; i < num_villages_; ++i) {
+        xs_[i] = problem.villages[i].coords.x;
+        ys_[i] = problem.villages[i].coords.y;
+    }
+    city_xs_.resize(num_cities_);
+    city_ys_.resize(num_cities_);
+    for (size_t c = 0; c < num_cities_; ++c) {
+        city_xs_[c] = problem.cities[c].x;
+        city_ys_[c] = problem.cities[c].y;
+    }
+
+    city_table_ = tables == Tables::All && num_cities_ * num_villages_ <= kMaxCityEntries;
+    if (city_table_) {
+        city_village_.resize(num_cities_ * num_villages_);
+        for (size_t c = 0; c < num_cities_; ++c) {
+            double* row = &city_village_[c * num_villages_];
+            for (size_t v = 0; v < num_villages_; ++v) {
+                row[v] = distance(problem.cities[c], problem.villages[v].coords);
+            }
+        }
+    } else {
+        city_village_.clear();
+    }
+
+    if (tables == Tables::None) {
+        layout_ = Layout::OnDemand;
+        village_village_.clear();
+        return;
+    }
+
+    size_t triangular_entries = num_villages_ * (num_villages_ > 0 ? num_villages_ - 1 : 0) / 2;
+    if (num_villages_ <= kMaxDenseVillages) {
+        layout_ = Layout::Dense;
+        village_village_.resize(num_villages_ * num_villages_);
+        for (size_t a = 0; a < num_villages_; ++a) {
+            village_village_[a * num_villages_ + a] = 0.0;
+            for (size_t b = 0; b < a; ++b) {
+                double d = distance(problem.villages[a].coords, problem.villages[b].coords);
+                village_village_[a * num_villages_ + b] = d;
+                village_village_[b * num_villages_ + a] = d;
+            }
+        }
+    } else if (triangular_entries <= kMaxTriangularEntries) {
+        layout_ = Layout::Triangular;
+        village_village_.resize(triangular_entries);
+        for (size_t a = 1; a < num_villages_; ++a) {
+            double* row = &village_village_[a * (a - 1) / 2];
+            for (size_t b = 0; b < a; ++b) {
+                row[b] = distance(problem.villages[a].coords, problem.villages[b].coords);
+            }
+        }
+    } else {
+        layout_ = Layout::OnDemand;
+        village_village_.clear();
+    }
+}
+
+double DistanceCache::tripDistance(int city_idx, const vector<Drop>& drops) const {
+    double total = 0.0;
+    int prev = -1;
+    for (const auto& drop : drops) {
+        int v = drop.village_id - 1;
+        total += (prev < 0) ? cityToVillage(city_idx, v) : villageToVillage(prev, v);
+        prev = v;
+    }
+    if (prev >= 0) total += cityToVillage(city_idx, prev);
+    return total;
+}
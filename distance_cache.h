@@ -0,0 +1,121 @@
+#ifndef DISTANCE_CACHE_H
+#define DISTANCE_CACHE_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "structures.h"
+
+// --- ALIGNED STORAGE ---
+
+/**
+ * @brief Allocator that places every buffer on a cache-line boundary.
+ */
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+    static constexpr std::size_t alignment = 64;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    template <typename U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = vector<T, CacheAlignedAllocator<T>>;
+
+// --- DISTANCE CACHE ---
+
+/**
+ * @brief Precomputed city->village and village->village distances for one ProblemData.
+ *
+ * City->village distances are stored as a dense [city][village] table of up to kMaxCityEntries
+ * entries, and computed from contiguous coordinates past that. Village->village distances use a
+ * dense square table for moderate village counts, a packed lower triangle for larger ones, and
+ * fall back to computing from contiguous coordinates when even the triangle would not fit the
+ * memory budget. Every entry is produced by distance(), so lookups are
+ * bit-identical to calling it directly. All indices are 0-based.
+ *
+ * Built with Tables::None, nothing is tabled and every lookup computes distance() from the stored
+ * coordinates. That suits a caller making a few lookups per drop, such as scoring one plan, for
+ * which the tables would cost far more memory and build time than the lookups they save.
+ */
+class DistanceCache {
+public:
+    enum class Layout { Dense, Triangular, OnDemand };
+    enum class Tables { All, None }; // What rebuild() precomputes.
+
+    static constexpr size_t kMaxDenseVillages = 4096;  // 128 MiB square table
+    static constexpr size_t kMaxTriangularEntries = size_t(1) << 26; // 512 MiB of doubles
+    static constexpr size_t kMaxCityEntries = size_t(1) << 26;       // 512 MiB of doubles
+
+    DistanceCache() = default;
+    explicit DistanceCache(const ProblemData& problem, Tables tables = Tables::All);
+
+    /**
+     * @brief Recomputes every table for another problem, reusing the existing buffers so a cache
+     * kept across instances only allocates when an instance needs more room than any before it.
+     */
+    void rebuild(const ProblemData& problem, Tables tables = Tables::All);
+
+    double cityToVillage(int city_idx, int village_idx) const {
+        if (!city_table_) return distance(Point{city_xs_[city_idx], city_ys_[city_idx]}, Point{xs_[village_idx], ys_[village_idx]});
+        return city_village_[static_cast<size_t>(city_idx) * num_villages_ + village_idx];
+    }
+
+    /**
+     * @brief Distances from one city to every village, indexed by village, or nullptr when the
+     * city table is not built (Tables::None, or above kMaxCityEntries). Use cityToVillage() then.
+     */
+    const double* cityRow(int city_idx) const {
+        return city_table_ ? city_village_.data() + static_cast<size_t>(city_idx) * num_villages_ : nullptr;
+    }
+
+    double villageToVillage(int a, int b) const {
+        switch (layout_) {
+            case Layout::Dense:
+                return village_village_[static_cast<size_t>(a) * num_villages_ + b];
+            case Layout::Triangular:
+                if (a == b) return 0.0;
+                if (a < b) { int t = a; a = b; b = t; }
+                return village_village_[static_cast<size_t>(a) * (a - 1) / 2 + b];
+            default:
+                return distance(Point{xs_[a], ys_[a]}, Point{xs_[b], ys_[b]});
+        }
+    }
+
+    /**
+     * @brief Length of the closed tour home city -> drops in order -> home city.
+     */
+    double tripDistance(int city_idx, const vector<Drop>& drops) const;
+
+    Layout layout() const { return layout_; }
+    Tables tables() const { return tables_; }
+    size_t numVillages() const { return num_villages_; }
+    size_t numCities() const { return num_cities_; }
+
+private:
+    size_t num_villages_ = 0;
+    size_t num_cities_ = 0;
+    Layout layout_ = Layout::Dense;
+    Tables tables_ = Tables::All;
+    bool city_table_ = false;
+    AlignedVector<double> city_village_;
+    AlignedVector<double> village_village_;
+    AlignedVector<double> xs_, ys_;
+    AlignedVector<double> city_xs_, city_ys_;
+};
+
+#endif // DISTANCE_CACHE_H
@@ -0,0 +1,158 @@
+#include "evaluator.h"
+#include <algorithm>
+
+using namespace std;
+
+SolutionEvaluator::SolutionEvaluator(const ProblemData& problem, const DistanceCache& dist)
+    : problem_(problem), dist_(dist),
+      village_drops_(problem.villages.size()),
+      village_value_(problem.villages.size(), 0.0),
+      plans_(problem.helicopters.size()),
+      next_seq_(problem.helicopters.size(), 0),
+      plan_rank_(problem.helicopters.size(), -1),
+      heli_distance_(problem.helicopters.size(), 0.0),
+      is_touched_(problem.villages.size(), 0) {}
+
+void SolutionEvaluator::reset() {
+    for (int v : touched_) {
+        village_drops_[v].clear();
+        village_value_[v] = 0.0;
+        is_touched_[v] = 0;
+    }
+    touched_.clear();
+    for (int h : plan_order_) {
+        plans_[h].clear();
+        next_seq_[h] = 0;
+        plan_rank_[h] = -1;
+        heli_distance_[h] = 0.0;
+    }
+    plan_order_.clear();
+}
+
+void SolutionEvaluator::load(const Solution& solution) {
+    reset();
+    for (const auto& plan : solution) {
+        int h = plan.helicopter_id - 1;
+        if (plan_rank_[h] < 0) {
+            plan_rank_[h] = static_cast<int>(plan_order_.size());
+            plan_order_.push_back(h);
+        }
+        for (const auto& trip : plan.trips) addTrip(h, trip);
+    }
+}
+
+void SolutionEvaluator::load(const FlatSolution& solution) {
+    reset();
+    Trip trip;
+    for (size_t p = 0; p < solution.numPlans(); ++p) {
+        int h = solution.planHelicopter(p) - 1;
+        if (plan_rank_[h] < 0) {
+            plan_rank_[h] = static_cast<int>(plan_order_.size());
+            plan_order_.push_back(h);
+        }
+        for (size_t t = solution.planTripBegin(p); t < solution.planTripEnd(p); ++t) {
+            solution.copyTrip(t, trip);
+            addTrip(h, trip);
+        }
+    }
+}
+
+// Mirrors the per-drop capping arithmetic of verifyAndCalculateScore operation for operation.
+double SolutionEvaluator::villageValue(int village_idx, const vector<DropRecord>& drops) const {
+    const auto& village = problem_.villages[village_idx];
+    double value = 0.0, food_delivered = 0.0, other_delivered = 0.0;
+    for (const auto& d : drops) {
+        double max_food_needed = village.population * 9.0;
+        double food_room_left = max(0.0, max_food_needed - food_delivered);
+        double food_in_this_drop = d.dry + d.perishable;
+        double effective_food_this_drop = min(food_in_this_drop, food_room_left);
+        double effective_vp = min((double)d.perishable, effective_food_this_drop);
+        double value_from_p = effective_vp * problem_.packages[1].value;
+        double remaining_effective_food = effective_food_this_drop - effective_vp;
+        double effective_vd = min((double)d.dry, remaining_effective_food);
+        double value_from_d = effective_vd * problem_.packages[0].value;
+        value += value_from_p + value_from_d;
+
+        double max_other_needed = village.population * 1.0;
+        double other_room_left = max(0.0, max_other_needed - other_delivered);
+        double effective_vo = min((double)d.other, other_room_left);
+        value += effective_vo * problem_.packages[2].value;
+
+        food_delivered += food_in_this_drop;
+        other_delivered += d.other;
+    }
+    return value;
+}
+
+double SolutionEvaluator::tripCost(int heli_idx, double trip_distance, const Trip& trip) const {
+    const auto& helicopter = problem_.helicopters[heli_idx];
+    return trip.drops.empty() ? 0.0 : helicopter.fixed_cost + (helicopter.alpha * trip_distance);
+}
+
+int SolutionEvaluator::rankOf(int heli_idx) const {
+    return plan_rank_[heli_idx] >= 0 ? plan_rank_[heli_idx] : static_cast<int>(plan_order_.size());
+}
+
+void SolutionEvaluator::insertDrops(int heli_idx, uint32_t seq, const Trip& trip) {
+    int rank = rankOf(heli_idx);
+    for (size_t pos = 0; pos < trip.drops.size(); ++pos) {
+        const Drop& drop = trip.drops[pos];
+        int v = drop.village_id - 1;
+        auto& list = village_drops_[v];
+        if (!is_touched_[v]) {
+            is_touched_[v] = 1;
+            touched_.push_back(v);
+        }
+        DropRecord rec = {dropKey(rank, seq, pos), drop.dry_food, drop.perishable_food, drop.other_supplies};
+        auto it = upper_bound(list.begin(), list.end(), rec.key, [](uint64_t k, const DropRecord& r) { return k < r.key; });
+        list.insert(it, rec);
+    }
+    for (const Drop& drop : trip.drops) {
+        int v = drop.village_id - 1;
+        village_value_[v] = villageValue(v, village_drops_[v]);
+    }
+}
+
+int SolutionEvaluator::addTrip(int heli_idx, const Trip& trip) {
+    if (plan_rank_[heli_idx] < 0) {
+        plan_rank_[heli_idx] = static_cast<int>(plan_order_.size());
+        plan_order_.push_back(heli_idx);
+    }
+    uint32_t seq = next_seq_[heli_idx]++;
+    insertDrops(heli_idx, seq, trip);
+    double d = dist_.tripDistance(problem_.helicopters[heli_idx].home_city_id - 1, trip.drops);
+    plans_[heli_idx].push_back({seq, d, tripCost(heli_idx, d, trip), trip});
+    heli_distance_[heli_idx] += d;
+    return static_cast<int>(plans_[heli_idx].size()) - 1;
+}
+
+double SolutionEvaluator::totalValue() const {
+    double total = 0.0;
+    for (double v : village_value_) total += v;
+    return total;
+}
+
+double SolutionEvaluator::totalCost() const {
+    double total = 0.0;
+    for (int h : plan_order_) {
+        for (const auto& rec : plans_[h]) total += rec.cost;
+    }
+    return total;
+}
+
+double SolutionEvaluator::objective() const {
+    return totalValue() - totalCost();
+}
+
+Solution SolutionEvaluator::solution() const {
+    Solution out;
+    for (int h : plan_order_) {
+        if (plans_[h].empty()) continue;
+        HelicopterPlan plan;
+        plan.helicopter_id = problem_.helicopters[h].id;
+        plan.trips.reserve(plans_[h].size());
+        for (const auto& rec : plans_[h]) plan.trips.push_back(rec.trip);
+        out.push_back(move(plan));
+    }
+    return out;
+}
@@ -0,0 +1,93 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <cstdint>
+#include <vector>
+#include "structures.h"
+#include "distance_cache.h"
+#include "flat_solution.h"
+
+/**
+ * @brief Stateful objective evaluator, scoring plans exactly like the checker.
+ *
+ * Holds, per village, the ordered list of drops it receives and, per helicopter, its trips,
+ * their distances and the helicopter's total distance. Village value is capped exactly as in
+ * format_checker's verifyAndCalculateScore: drops are applied in plan order, then trip order,
+ * then drop order, and perishable food counts before dry food within each drop. Plans are
+ * ordered by first appearance (load() order, then first addTrip()). Trips are addressed by
+ * (0-based helicopter index, position in that helicopter's plan).
+ */
+class SolutionEvaluator {
+public:
+    SolutionEvaluator(const ProblemData& problem, const DistanceCache& dist);
+
+    /**
+     * @brief Empties the solution. Keeps allocated capacity for reuse.
+     */
+    void reset();
+
+    /**
+     * @brief Replaces the current state with the given solution.
+     */
+    void load(const Solution& solution);
+    void load(const FlatSolution& solution);
+
+    /**
+     * @brief Appends a trip to the helicopter's plan and returns its position.
+     */
+    int addTrip(int heli_idx, const Trip& trip);
+
+    /**
+     * @brief Total value minus total trip cost, summed in the same order as the checker. O(V + T).
+     */
+    double objective() const;
+
+    double totalValue() const;
+    double totalCost() const;
+
+    double helicopterDistance(int heli_idx) const { return heli_distance_[heli_idx]; }
+    double tripDistance(int heli_idx, int pos) const { return plans_[heli_idx][pos].distance; }
+    int numTrips(int heli_idx) const { return static_cast<int>(plans_[heli_idx].size()); }
+    const Trip& trip(int heli_idx, int pos) const { return plans_[heli_idx][pos].trip; }
+
+    /**
+     * @brief Exports the current state as a Solution, in plan order, skipping empty plans.
+     */
+    Solution solution() const;
+
+private:
+    struct DropRecord {
+        uint64_t key;   // (plan rank, trip sequence, position in trip), ordered like the output file
+        int dry, perishable, other;
+    };
+    struct TripRecord {
+        uint32_t seq;
+        double distance;
+        double cost;
+        Trip trip;
+    };
+
+    static uint64_t dropKey(int rank, uint32_t seq, size_t pos) {
+        return (static_cast<uint64_t>(rank) << 44) | (static_cast<uint64_t>(seq) << 20) | pos;
+    }
+
+    double villageValue(int village_idx, const vector<DropRecord>& drops) const;
+    double tripCost(int heli_idx, double trip_distance, const Trip& trip) const;
+    int rankOf(int heli_idx) const;
+    void insertDrops(int heli_idx, uint32_t seq, const Trip& trip);
+
+    const ProblemData& problem_;
+    const DistanceCache& dist_;
+
+    vector<vector<DropRecord>> village_drops_;
+    vector<double> village_value_;
+    vector<vector<TripRecord>> plans_;
+    vector<uint32_t> next_seq_;
+    vector<int> plan_rank_;       // -1 until the helicopter's plan first appears
+    vector<int> plan_order_;      // helicopter indices by rank
+    vector<double> heli_distance_;
+    vector<int> touched_;         // villages with drops since the last reset
+    vector<char> is_touched_;
+};
+
+#endif // EVALUATOR_H
@@ -0,0 +1,102 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <cstdlib>
+
+#include "structures.h"
+#include "distance_cache.h"
+#include "scoring.h"
+#include "instance_generator.h"
+#include "evaluator.h"
+
+using namespace std;
+
+/**
+ * @brief Randomized cross-check of SolutionEvaluator against SolutionScorer.
+ *
+ * Edits a plan with random sequences of trip additions, removals and replacements on a synthetic
+ * instance. Additions go through addTrip(); after a removal or a replacement the edited plan is
+ * load()ed again. After every edit the evaluator's objective() must equal the objective the
+ * checker's scorer gives the same plan, bit for bit. Drops repeat villages and often exceed their
+ * needs, so the per-drop capping order is exercised. Exits non-zero on the first difference.
+ * Usage: evaluator_check [num_villages] [edits]
+ */
+
+static Trip randomTrip(const ProblemData& problem, mt19937& gen) {
+    const int num_villages = static_cast<int>(problem.villages.size());
+    Trip trip = {0, 0, 0, {}};
+    const int num_drops = static_cast<int>(gen() % 5); // Empty trips cost nothing, but are still scored.
+    for (int i = 0; i < num_drops; ++i) {
+        const int v = static_cast<int>(gen() % num_villages);
+        const int population = problem.villages[v].population;
+        Drop drop = {v + 1, static_cast<int>(gen() % (6 * population + 1)), static_cast<int>(gen() % (6 * population + 1)),
+                     static_cast<int>(gen() % (population + 2))};
+        trip.dry_food_pickup += drop.dry_food;
+        trip.perishable_food_pickup += drop.perishable_food;
+        trip.other_supplies_pickup += drop.other_supplies;
+        trip.drops.push_back(drop);
+    }
+    return trip;
+}
+
+int main(int argc, char* argv[]) {
+    int num_villages = argc > 1 ? atoi(argv[1]) : 50;
+    int num_edits = argc > 2 ? atoi(argv[2]) : 20000;
+
+    GeneratorParams params;
+    params.num_villages = num_villages;
+    params.seed = 11;
+    ProblemData problem = generateInstance(params);
+    DistanceCache dist(problem);
+    SolutionScorer scorer(problem, dist);
+    SolutionEvaluator eval(problem, dist);
+    const int num_helicopters = static_cast<int>(problem.helicopters.size());
+
+    mt19937 gen(3);
+    Solution plan;
+    int trips = 0, adds = 0, removes = 0, replaces = 0;
+    for (int e = 0; e < num_edits; ++e) {
+        const unsigned op = gen() % 8;
+        if (op == 0) {
+            // Start over with an empty plan now and then, so the plan order is reshuffled.
+            plan.clear();
+            trips = 0;
+            eval.reset();
+        } else if (op <= 4 || trips == 0) {
+            const int h = static_cast<int>(gen() % num_helicopters);
+            Trip trip = randomTrip(problem, gen);
+            size_t p = 0;
+            while (p < plan.size() && plan[p].helicopter_id != h + 1) ++p;
+            if (p == plan.size()) plan.push_back({h + 1, {}});
+            plan[p].trips.push_back(trip);
+            eval.addTrip(h, trip);
+            ++trips;
+            ++adds;
+        } else {
+            // Picks a trip uniformly among all trips of the plan.
+            int k = static_cast<int>(gen() % trips);
+            size_t p = 0;
+            while (k >= static_cast<int>(plan[p].trips.size())) k -= static_cast<int>(plan[p++].trips.size());
+            if (op <= 6) {
+                plan[p].trips.erase(plan[p].trips.begin() + k);
+                --trips;
+                ++removes;
+            } else {
+                plan[p].trips[k] = randomTrip(problem, gen);
+                ++replaces;
+            }
+            eval.load(plan);
+        }
+
+        const double expected = scorer.score(plan).objective;
+        const double actual = eval.objective();
+        if (actual != expected) {
+            cerr << setprecision(17) << "MISMATCH after edit " << e << ": evaluator " << actual << ", scorer " << expected << endl;
+            return 1;
+        }
+    }
+    cout << "cross-check: " << num_edits << " edits (" << adds << " adds, " << removes << " removes, " << replaces
+         << " replaces) score identically" << endl;
+    return 0;
+}
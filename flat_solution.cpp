@@ -0,0 +1,49 @@
+#include "flat_solution.h"
+
+using namespace std;
+
+void FlatSolution::clear() {
+    plans_.clear();
+    trips_.clear();
+    drops_.clear();
+}
+
+void FlatSolution::addPlan(int helicopter_id) {
+    plans_.push_back({helicopter_id, static_cast<uint32_t>(trips_.size())});
+}
+
+void FlatSolution::addTrip(const Trip& trip) {
+    addTrip(trip.dry_food_pickup, trip.perishable_food_pickup, trip.other_supplies_pickup, trip.drops.data(), trip.drops.data() + trip.drops.size());
+}
+
+void FlatSolution::addTrip(int dry_food_pickup, int perishable_food_pickup, int other_supplies_pickup, const Drop* drops_begin, const Drop* drops_end) {
+    trips_.push_back({dry_food_pickup, perishable_food_pickup, other_supplies_pickup, static_cast<uint32_t>(drops_.size())});
+    drops_.insert(drops_.end(), drops_begin, drops_end);
+}
+
+void FlatSolution::assign(const Solution& solution) {
+    clear();
+    for (const auto& plan : solution) {
+        addPlan(plan.helicopter_id);
+        for (const auto& trip : plan.trips) addTrip(trip);
+    }
+}
+
+Solution FlatSolution::toSolution() const {
+    Solution solution(plans_.size());
+    for (size_t p = 0; p < plans_.size(); ++p) {
+        HelicopterPlan& plan = solution[p];
+        plan.helicopter_id = plans_[p].helicopter_id;
+        plan.trips.resize(planTripEnd(p) - planTripBegin(p));
+        for (size_t t = planTripBegin(p); t < planTripEnd(p); ++t) copyTrip(t, plan.trips[t - planTripBegin(p)]);
+    }
+    return solution;
+}
+
+void FlatSolution::copyTrip(size_t t, Trip& out) const {
+    const TripHeader& header = trips_[t];
+    out.dry_food_pickup = header.dry_food_pickup;
+    out.perishable_food_pickup = header.perishable_food_pickup;
+    out.other_supplies_pickup = header.other_supplies_pickup;
+    out.drops.assign(tripDropsBegin(t), tripDropsEnd(t));
+}
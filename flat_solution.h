@@ -0,0 +1,93 @@
+#ifndef FLAT_SOLUTION_H
+#define FLAT_SOLUTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "structures.h"
+
+/**
+ * @brief Compact Solution: every drop in one array, with trip and plan offset tables into it.
+ *
+ * The three arrays are the solution's arena. clear() forgets the contents but keeps the
+ * capacity, so a FlatSolution rebuilt once per search iteration stops allocating after the
+ * first few iterations, and copying one costs three flat copies rather than an allocation per
+ * trip. swap() exchanges two solutions in O(1), which is how best-so-far tracking keeps a new
+ * best without copying it.
+ *
+ * A solution is built in output order: addPlan() for a helicopter, then addTrip() for each of
+ * its trips. Plans, trips and drops are addressed by 0-based position; a plan's trips are the
+ * positions [planTripBegin(p), planTripEnd(p)).
+ */
+class FlatSolution {
+public:
+    struct TripHeader {
+        int dry_food_pickup = 0;
+        int perishable_food_pickup = 0;
+        int other_supplies_pickup = 0;
+        uint32_t first_drop = 0; // The trip's drops run up to the next trip's first_drop.
+    };
+
+    FlatSolution() = default;
+    explicit FlatSolution(const Solution& solution) { assign(solution); }
+
+    /**
+     * @brief Empties the solution. Keeps allocated capacity for reuse.
+     */
+    void clear();
+
+    void addPlan(int helicopter_id);
+
+    /**
+     * @brief Appends a trip to the last plan added.
+     */
+    void addTrip(const Trip& trip);
+    void addTrip(int dry_food_pickup, int perishable_food_pickup, int other_supplies_pickup, const Drop* drops_begin, const Drop* drops_end);
+
+    /**
+     * @brief Replaces the contents with a copy of solution, reusing capacity.
+     */
+    void assign(const Solution& solution);
+
+    Solution toSolution() const;
+
+    /**
+     * @brief Copies trip t into out, reusing out's drop buffer.
+     */
+    void copyTrip(size_t t, Trip& out) const;
+
+    void swap(FlatSolution& other) noexcept {
+        plans_.swap(other.plans_);
+        trips_.swap(other.trips_);
+        drops_.swap(other.drops_);
+    }
+
+    bool empty() const { return plans_.empty(); }
+    size_t numPlans() const { return plans_.size(); }
+    size_t numTrips() const { return trips_.size(); }
+    size_t numDrops() const { return drops_.size(); }
+
+    int planHelicopter(size_t p) const { return plans_[p].helicopter_id; }
+    size_t planTripBegin(size_t p) const { return plans_[p].first_trip; }
+    size_t planTripEnd(size_t p) const { return p + 1 < plans_.size() ? plans_[p + 1].first_trip : trips_.size(); }
+
+    const TripHeader& trip(size_t t) const { return trips_[t]; }
+    const Drop* tripDropsBegin(size_t t) const { return drops_.data() + trips_[t].first_drop; }
+    const Drop* tripDropsEnd(size_t t) const { return drops_.data() + (t + 1 < trips_.size() ? trips_[t + 1].first_drop : drops_.size()); }
+
+private:
+    struct PlanHeader {
+        int helicopter_id;
+        uint32_t first_trip; // The plan's trips run up to the next plan's first_trip.
+    };
+
+    std::vector<PlanHeader> plans_;
+    std::vector<TripHeader> trips_;
+    std::vector<Drop> drops_;
+};
+
+inline void swap(FlatSolution& a, FlatSolution& b) noexcept {
+    a.swap(b);
+}
+
+#endif // FLAT_SOLUTION_H
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "structures.h"
+#include "io_handler.h"
+#include "instance_generator.h"
+
+using namespace std;
+
+/**
+ * @brief Writes a synthetic instance in the input format.
+ * Usage: gen_instance <output_filename> [--villages N] [--cities N] [--helicopters N] [--area X]
+ *        [--clustering X] [--spread X] [--tightness X] [--time-limit MINUTES] [--seed S]
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " <output_filename> [--villages N] [--cities N] [--helicopters N] [--area X]"
+             << " [--clustering X] [--spread X] [--tightness X] [--time-limit MINUTES] [--seed S]" << endl;
+        return 1;
+    }
+
+    GeneratorParams params;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for option: " << arg << endl;
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--villages") params.num_villages = atoi(value);
+        else if (arg == "--cities") params.num_cities = atoi(value);
+        else if (arg == "--helicopters") params.num_helicopters = atoi(value);
+        else if (arg == "--area") params.area = atof(value);
+        else if (arg == "--clustering") params.clustering = atof(value);
+        else if (arg == "--spread") params.cluster_spread = atof(value);
+        else if (arg == "--tightness") params.tightness = atof(value);
+        else if (arg == "--time-limit") params.time_limit_minutes = atof(value);
+        else if (arg == "--seed") params.seed = strtoul(value, nullptr, 10);
+        else {
+            cerr << "Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+
+    try {
+        writeInputData(argv[1], generateInstance(params));
+    } catch (const runtime_error& e) {
+        cerr << "An error occurred: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
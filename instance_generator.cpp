@@ -0,0 +1,96 @@
+#include "instance_generator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Portable random draws on top of mt19937.
+ */
+class Draw {
+public:
+    explicit Draw(unsigned seed) : gen_(seed) {}
+
+    // Uniform in [0, 1).
+    double unit() { return gen_() * (1.0 / 4294967296.0); }
+    double uniform(double lo, double hi) { return lo + (hi - lo) * unit(); }
+    // Uniform integer in [lo, hi].
+    int integer(int lo, int hi) { return lo + static_cast<int>(unit() * (hi - lo + 1)); }
+    // Standard normal (Box-Muller).
+    double normal() {
+        double u1 = 1.0 - unit();
+        double u2 = unit();
+        return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+    }
+    template <typename T, size_t N>
+    T pick(const T (&choices)[N]) { return choices[integer(0, N - 1)]; }
+
+private:
+    mt19937 gen_;
+};
+
+double lerp(double loose, double tight, double t) {
+    return loose + (tight - loose) * t;
+}
+
+double roundCoord(double c) {
+    return round(c * 1000.0) / 1000.0;
+}
+
+} // namespace
+
+ProblemData generateInstance(const GeneratorParams& params) {
+    if (params.num_villages < 0 || params.num_cities < 1 || params.num_helicopters < 0) {
+        throw runtime_error("Error: An instance needs at least one city and non-negative village and helicopter counts");
+    }
+    Draw draw(params.seed);
+    const double t = max(0.0, min(1.0, params.tightness));
+    const double area = params.area;
+
+    ProblemData problem;
+    problem.time_limit_minutes = params.time_limit_minutes;
+    problem.d_max = roundCoord(area * lerp(8.0, 2.0, t));
+    problem.packages = {{0.01, 1.0}, {0.1, 2.0}, {0.005, 0.5}}; // dry, perishable, other: {weight, value}
+
+    problem.cities.resize(params.num_cities);
+    for (auto& city : problem.cities) {
+        city.x = roundCoord(draw.uniform(0.0, area));
+        city.y = roundCoord(draw.uniform(0.0, area));
+    }
+
+    const double sigma = params.cluster_spread * area;
+    problem.villages.resize(params.num_villages);
+    for (int i = 0; i < params.num_villages; ++i) {
+        Village& village = problem.villages[i];
+        village.id = i + 1;
+        if (draw.unit() < params.clustering) {
+            const Point& centre = problem.cities[draw.integer(0, params.num_cities - 1)];
+            village.coords.x = roundCoord(centre.x + sigma * draw.normal());
+            village.coords.y = roundCoord(centre.y + sigma * draw.normal());
+        } else {
+            village.coords.x = roundCoord(draw.uniform(0.0, area));
+            village.coords.y = roundCoord(draw.uniform(0.0, area));
+        }
+        village.population = draw.integer(5, 200);
+    }
+
+    const double weight_capacities[] = {50.0, 80.0, 120.0};
+    const double range_factors[] = {0.6, 1.0, 1.5};
+    const double fixed_costs[] = {5.0, 10.0, 20.0};
+    const double alphas[] = {0.5, 1.0, 2.0};
+    problem.helicopters.resize(params.num_helicopters);
+    for (int i = 0; i < params.num_helicopters; ++i) {
+        Helicopter& helicopter = problem.helicopters[i];
+        helicopter.id = i + 1;
+        helicopter.home_city_id = draw.integer(1, params.num_cities);
+        helicopter.weight_capacity = draw.pick(weight_capacities) * lerp(1.5, 0.5, t);
+        helicopter.distance_capacity = roundCoord(draw.pick(range_factors) * area * lerp(1.5, 0.5, t));
+        helicopter.fixed_cost = draw.pick(fixed_costs);
+        helicopter.alpha = draw.pick(alphas);
+    }
+    return problem;
+}
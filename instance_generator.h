@@ -0,0 +1,29 @@
+#ifndef INSTANCE_GENERATOR_H
+#define INSTANCE_GENERATOR_H
+
+#include "structures.h"
+
+/**
+ * @brief Shape of a synthetic instance.
+ */
+struct GeneratorParams {
+    int num_villages = 1000;
+    int num_cities = 5;
+    int num_helicopters = 10;
+    double area = 100.0;              // Side of the square map, in distance units.
+    double clustering = 0.7;          // Share of villages placed around a city (Gaussian); the rest are uniform.
+    double cluster_spread = 0.08;     // Standard deviation of a cluster, as a fraction of the area.
+    double tightness = 0.5;           // 0 = roomy capacities and DMax, 1 = tight ones.
+    double time_limit_minutes = 0.1;
+    unsigned seed = 1;
+};
+
+/**
+ * @brief Builds a random instance from params. The same params always give the same instance:
+ * random numbers come from mt19937 and are mapped to ranges by hand rather than through the
+ * standard library's distributions, whose output differs between implementations.
+ * Coordinates are rounded to three decimals.
+ */
+ProblemData generateInstance(const GeneratorParams& params);
+
+#endif // INSTANCE_GENERATOR_H
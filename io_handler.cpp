@@ -1,85 +1,360 @@
 #include "io_handler.h"
-#include <fstream>
-#include <sstream>
 #include <stdexcept>
+#include <charconv>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
-ProblemData readInputData(const string& filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
-        throw runtime_error("Error: Could not open input file " + filename);
+namespace {
+
+/**
+ * @brief Read-only view of a whole file, memory-mapped when possible and read into a buffer otherwise.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const string& filename) {
+        fd_ = open(filename.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw runtime_error("Error: Could not open input file " + filename);
+        }
+        struct stat st;
+        if (fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (mapped != MAP_FAILED) {
+                madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(mapped);
+                size_ = st.st_size;
+                mapped_ = true;
+                return;
+            }
+        }
+        char chunk[1 << 16];
+        ssize_t n;
+        while ((n = read(fd_, chunk, sizeof(chunk))) > 0) buffer_.append(chunk, n);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    ~MappedFile() {
+        if (mapped_) munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    string buffer_;
+};
+
+/**
+ * @brief Line-aware number reader over a byte range. Every value of a section (or trip) must sit
+ * on that line; malformed or missing values are reported with their byte offset.
+ */
+class InputCursor {
+public:
+    InputCursor(const char* data, size_t size, const string& filename)
+        : begin_(data), p_(data), end_(data + size), filename_(filename) {}
+
+    template <typename T>
+    T next(const char* what) {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\v' || *p_ == '\f')) ++p_;
+        if (p_ < end_ && *p_ == '+') ++p_;
+        T value{};
+        auto result = from_chars(p_, end_, value);
+        if (result.ec != errc()) {
+            fail(what);
+        }
+        p_ = result.ptr;
+        return value;
+    }
+
+    // Skips blank lines; returns false at end of file.
+    bool skipBlankLines() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r' || *p_ == '\v' || *p_ == '\f')) ++p_;
+        return p_ < end_;
+    }
+
+    bool atEnd() const { return p_ >= end_; }
+
+    // Skips whatever is left of the current line, including its newline.
+    void nextLine() {
+        const void* nl = memchr(p_, '\n', end_ - p_);
+        p_ = nl ? static_cast<const char*>(nl) + 1 : end_;
     }
 
+    [[noreturn]] void fail(const char* what) const {
+        string found = (p_ >= end_) ? "end of file" : (*p_ == '\n') ? "end of line" : "'" + string(p_, min<size_t>(16, memcspn(p_, end_ - p_))) + "'";
+        throw runtime_error("Error: Malformed file " + filename_ + " at byte " + to_string(p_ - begin_) + ": expected " + what + ", found " + found);
+    }
+
+private:
+    static size_t memcspn(const char* s, size_t n) {
+        size_t i = 0;
+        while (i < n && s[i] != ' ' && s[i] != '\t' && s[i] != '\n' && s[i] != '\r') ++i;
+        return i;
+    }
+
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    const string& filename_;
+};
+
+} // namespace
+
+ProblemData readInputData(const string& filename) {
+    MappedFile file(filename);
+    InputCursor in(file.data(), file.size(), filename);
+
     ProblemData data;
-    string line;
 
     // Line 1: Processing time
-    getline(file, line);
-    stringstream(line) >> data.time_limit_minutes;
+    data.time_limit_minutes = in.next<double>("time limit");
+    in.nextLine();
 
     // Line 2: DMax
-    getline(file, line);
-    stringstream(line) >> data.d_max;
+    data.d_max = in.next<double>("DMax");
+    in.nextLine();
 
     // Line 3: Package weights and values
-    getline(file, line);
-    stringstream pkg_ss(line);
     data.packages.resize(3);
-    pkg_ss >> data.packages[0].weight >> data.packages[0].value;
-    pkg_ss >> data.packages[1].weight >> data.packages[1].value;
-    pkg_ss >> data.packages[2].weight >> data.packages[2].value;
+    for (int i = 0; i < 3; ++i) {
+        data.packages[i].weight = in.next<double>("package weight");
+        data.packages[i].value = in.next<double>("package value");
+    }
+    in.nextLine();
 
     // Line 4: Cities
-    getline(file, line);
-    stringstream city_ss(line);
-    int num_cities;
-    city_ss >> num_cities;
+    int num_cities = in.next<int>("city count");
+    if (num_cities < 0) in.fail("non-negative city count");
     data.cities.resize(num_cities);
     for (int i = 0; i < num_cities; ++i) {
-        city_ss >> data.cities[i].x >> data.cities[i].y;
+        data.cities[i].x = in.next<double>("city x");
+        data.cities[i].y = in.next<double>("city y");
     }
+    in.nextLine();
 
     // Line 5: Villages
-    getline(file, line);
-    stringstream village_ss(line);
-    int num_villages;
-    village_ss >> num_villages;
+    int num_villages = in.next<int>("village count");
+    if (num_villages < 0) in.fail("non-negative village count");
     data.villages.resize(num_villages);
     for (int i = 0; i < num_villages; ++i) {
         data.villages[i].id = i + 1;
-        village_ss >> data.villages[i].coords.x >> data.villages[i].coords.y >> data.villages[i].population;
+        data.villages[i].coords.x = in.next<double>("village x");
+        data.villages[i].coords.y = in.next<double>("village y");
+        data.villages[i].population = in.next<int>("village population");
     }
+    in.nextLine();
 
     // Line 6: Helicopters
-    getline(file, line);
-    stringstream heli_ss(line);
-    int num_helicopters;
-    heli_ss >> num_helicopters;
+    int num_helicopters = in.next<int>("helicopter count");
+    if (num_helicopters < 0) in.fail("non-negative helicopter count");
     data.helicopters.resize(num_helicopters);
     for (int i = 0; i < num_helicopters; ++i) {
         data.helicopters[i].id = i + 1;
-        heli_ss >> data.helicopters[i].home_city_id >> data.helicopters[i].weight_capacity >> data.helicopters[i].distance_capacity >> data.helicopters[i].fixed_cost >> data.helicopters[i].alpha;
+        data.helicopters[i].home_city_id = in.next<int>("helicopter home city");
+        data.helicopters[i].weight_capacity = in.next<double>("helicopter weight capacity");
+        data.helicopters[i].distance_capacity = in.next<double>("helicopter distance capacity");
+        data.helicopters[i].fixed_cost = in.next<double>("helicopter fixed cost");
+        data.helicopters[i].alpha = in.next<double>("helicopter alpha");
     }
 
     return data;
 }
 
 
-void writeOutputData(const string& filename, const Solution& solution) {
-    ofstream file(filename);
-    if (!file.is_open()) {
-        throw runtime_error("Error: Could not open output file " + filename);
+Solution readSolutionData(const string& filename) {
+    MappedFile file(filename);
+    InputCursor in(file.data(), file.size(), filename);
+
+    Solution solution;
+    while (in.skipBlankLines()) {
+        HelicopterPlan plan;
+        plan.helicopter_id = in.next<int>("helicopter ID");
+        if (plan.helicopter_id == -1) {
+            in.nextLine();
+            continue;
+        }
+        int num_trips = in.next<int>("trip count");
+        if (num_trips < 0) in.fail("non-negative trip count");
+        in.nextLine();
+
+        plan.trips.resize(num_trips);
+        for (auto& trip : plan.trips) {
+            if (in.atEnd()) {
+                throw runtime_error("Error: Unexpected end of file for helicopter " + to_string(plan.helicopter_id) + ".");
+            }
+            trip.dry_food_pickup = in.next<int>("dry food pickup");
+            trip.perishable_food_pickup = in.next<int>("perishable food pickup");
+            trip.other_supplies_pickup = in.next<int>("other supplies pickup");
+            int num_drops = in.next<int>("drop count");
+            if (num_drops < 0) in.fail("non-negative drop count");
+            trip.drops.resize(num_drops);
+            for (auto& drop : trip.drops) {
+                drop.village_id = in.next<int>("village ID");
+                drop.dry_food = in.next<int>("dry food drop");
+                drop.perishable_food = in.next<int>("perishable food drop");
+                drop.other_supplies = in.next<int>("other supplies drop");
+            }
+            in.nextLine();
+        }
+
+        // Each plan is closed by a -1 line.
+        in.nextLine();
+        solution.push_back(move(plan));
+    }
+    return solution;
+}
+
+namespace {
+
+/**
+ * @brief Formats numbers with to_chars into a fixed buffer and hands it to the file in large writes.
+ * Doubles use the shortest representation that reads back to the same value.
+ */
+class OutputBuffer {
+public:
+    OutputBuffer(int fd, const string& filename) : fd_(fd), filename_(filename) {}
+
+    void put(char c) {
+        if (len_ == sizeof(buf_)) flush();
+        buf_[len_++] = c;
+    }
+
+    template <typename T>
+    void put(T value) {
+        if (sizeof(buf_) - len_ < kMaxNumberChars) flush();
+        len_ = to_chars(buf_ + len_, buf_ + sizeof(buf_), value).ptr - buf_;
     }
 
+    void flush() {
+        size_t done = 0;
+        while (done < len_) {
+            ssize_t n = write(fd_, buf_ + done, len_ - done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw runtime_error("Error: Could not write output file " + filename_);
+            }
+            done += n;
+        }
+        len_ = 0;
+    }
+
+private:
+    static const size_t kMaxNumberChars = 32;
+
+    int fd_;
+    const string& filename_;
+    char buf_[1 << 16];
+    size_t len_ = 0;
+};
+
+void writeSolution(OutputBuffer& out, const Solution& solution) {
     for (const auto& plan : solution) {
-        file << plan.helicopter_id << " " << plan.trips.size() << "\n";
+        out.put(plan.helicopter_id); out.put(' '); out.put(plan.trips.size()); out.put('\n');
         for (const auto& trip : plan.trips) {
-            file << trip.dry_food_pickup << " " << trip.perishable_food_pickup << " " << trip.other_supplies_pickup << " " << trip.drops.size();
+            out.put(trip.dry_food_pickup); out.put(' ');
+            out.put(trip.perishable_food_pickup); out.put(' ');
+            out.put(trip.other_supplies_pickup); out.put(' ');
+            out.put(trip.drops.size());
             for (const auto& drop : trip.drops) {
-                file << " " << drop.village_id << " " << drop.dry_food << " " << drop.perishable_food << " " << drop.other_supplies;
+                out.put(' '); out.put(drop.village_id);
+                out.put(' '); out.put(drop.dry_food);
+                out.put(' '); out.put(drop.perishable_food);
+                out.put(' '); out.put(drop.other_supplies);
             }
-            file << "\n";
+            out.put('\n');
+        }
+        out.put(-1); out.put('\n');
+    }
+    out.flush();
+}
+
+void writeProblem(OutputBuffer& out, const ProblemData& problem) {
+    out.put(problem.time_limit_minutes); out.put('\n');
+    out.put(problem.d_max); out.put('\n');
+    for (size_t i = 0; i < problem.packages.size(); ++i) {
+        if (i > 0) out.put(' ');
+        out.put(problem.packages[i].weight); out.put(' '); out.put(problem.packages[i].value);
+    }
+    out.put('\n');
+    out.put(problem.cities.size());
+    for (const auto& city : problem.cities) {
+        out.put(' '); out.put(city.x); out.put(' '); out.put(city.y);
+    }
+    out.put('\n');
+    out.put(problem.villages.size());
+    for (const auto& village : problem.villages) {
+        out.put(' '); out.put(village.coords.x); out.put(' '); out.put(village.coords.y);
+        out.put(' '); out.put(village.population);
+    }
+    out.put('\n');
+    out.put(problem.helicopters.size());
+    for (const auto& helicopter : problem.helicopters) {
+        out.put(' '); out.put(helicopter.home_city_id);
+        out.put(' '); out.put(helicopter.weight_capacity);
+        out.put(' '); out.put(helicopter.distance_capacity);
+        out.put(' '); out.put(helicopter.fixed_cost);
+        out.put(' '); out.put(helicopter.alpha);
+    }
+    out.put('\n');
+    out.flush();
+}
+
+/**
+ * @brief Creates (or truncates) filename and fills it through an OutputBuffer. With atomic set,
+ * the content goes to a synced sibling temp file that is then renamed over filename.
+ */
+template <typename Fill>
+void writeFile(const string& filename, bool atomic, Fill fill) {
+    const string target = atomic ? filename + ".tmp." + to_string(getpid()) : filename;
+    int fd = open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw runtime_error("Error: Could not open output file " + target);
+    }
+
+    try {
+        auto out = make_unique<OutputBuffer>(fd, target);
+        fill(*out);
+        if (atomic && fsync(fd) != 0) {
+            throw runtime_error("Error: Could not sync output file " + target);
         }
-        file << -1 << "\n";
+    } catch (...) {
+        close(fd);
+        if (atomic) unlink(target.c_str());
+        throw;
     }
+    if (close(fd) != 0) {
+        if (atomic) unlink(target.c_str());
+        throw runtime_error("Error: Could not write output file " + target);
+    }
+
+    if (atomic && rename(target.c_str(), filename.c_str()) != 0) {
+        unlink(target.c_str());
+        throw runtime_error("Error: Could not replace output file " + filename);
+    }
+}
+
+} // namespace
+
+void writeOutputData(const string& filename, const Solution& solution, bool atomic) {
+    writeFile(filename, atomic, [&](OutputBuffer& out) { writeSolution(out, solution); });
+}
+
+void writeInputData(const string& filename, const ProblemData& problem) {
+    writeFile(filename, false, [&](OutputBuffer& out) { writeProblem(out, problem); });
 }
@@ -11,11 +11,27 @@
  */
 ProblemData readInputData(const std::string& filename);
 
+/**
+ * @brief Reads a solution file in the output format (the inverse of writeOutputData).
+ * * @param filename The path to the solution file.
+ * @return The plans in file order, exactly as written; nothing is validated beyond the syntax.
+ */
+Solution readSolutionData(const std::string& filename);
+
 /**
  * @brief Writes the generated solution to an output file in the specified format.
  * * @param filename The path to the output file.
  * @param solution The solution object to write.
+ * @param atomic When true, the solution is written to a temporary file next to filename, synced,
+ *        and renamed over filename, so readers never see a partially written file.
+ */
+void writeOutputData(const std::string& filename, const Solution& solution, bool atomic = false);
+
+/**
+ * @brief Writes a problem in the input format (the inverse of readInputData).
+ * * @param filename The path to the input file to create.
+ * @param problem The problem to write; readInputData returns it unchanged.
  */
-void writeOutputData(const std::string& filename, const Solution& solution);
+void writeInputData(const std::string& filename, const ProblemData& problem);
 
 #endif // IO_HANDLER_H
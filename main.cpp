@@ -1,17 +1,95 @@
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <csignal>
+#include <filesystem>
 #include "structures.h"
 #include "io_handler.h"
 #include "solver.h"
+#include "batch.h"
 
 using namespace std;
 
+// Raised by SIGINT/SIGTERM so the solver stops and the best plan found so far is still written.
+static CancellationToken g_cancel;
+
+extern "C" void handleStopSignal(int) {
+    g_cancel.cancel();
+}
+
+/**
+ * @brief Solves every instance of a manifest or directory in this process and prints a summary.
+ */
+static int runBatchMode(const string& source, const string& output_dir, const BatchOptions& options) {
+    try {
+        filesystem::create_directories(output_dir);
+        vector<BatchEntry> entries = listBatchEntries(source, output_dir);
+        cout << "Solving " << entries.size() << " instances from " << source << endl;
+
+        vector<BatchResult> results = runBatch(entries, options);
+        const string summary_filename = (filesystem::path(output_dir) / "summary.tsv").string();
+        writeBatchSummary(summary_filename, results);
+        cout << endl;
+        printBatchTable(cout, results);
+        cout << "Wrote summary to " << summary_filename << endl;
+
+        for (const auto& r : results) {
+            if (r.status != "ok") return 1;
+        }
+    } catch (const exception& e) {
+        cerr << "An error occurred: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        cerr << "Usage: " << argv[0] << " <input_filename> <output_filename>" << endl;
+    const bool batch = argc > 1 && string(argv[1]) == "--batch";
+    const int first_option = batch ? 4 : 3;
+    if (argc < first_option) {
+        cerr << "Usage: " << argv[0] << " <input_filename> <output_filename> [--threads N] [--seed S] [--iterations N] [--neighbors K] [--gap-tolerance G] [--ratio-walk] [--no-checkpoint] [--warm-start FILE]" << endl;
+        cerr << "       " << argv[0] << " --batch <manifest_or_directory> <output_directory> [--jobs N] [--threads N] [--seed S] [--iterations N] [--neighbors K] [--gap-tolerance G] [--ratio-walk]" << endl;
         return 1;
     }
 
+    BatchOptions batch_options;
+    bool checkpoint = true;
+    string warm_start_filename;
+    SolverOptions& options = batch_options.solver;
+    options.cancel = &g_cancel;
+    for (int i = first_option; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.num_threads = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = strtoll(argv[++i], nullptr, 10);
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            options.iteration_budget = atol(argv[++i]);
+        } else if (arg == "--neighbors" && i + 1 < argc) {
+            options.candidate_neighbors = atoi(argv[++i]);
+        } else if (arg == "--gap-tolerance" && i + 1 < argc) {
+            options.gap_tolerance = atof(argv[++i]);
+        } else if (arg == "--ratio-walk") {
+            options.ratio_walk = true;
+        } else if (!batch && arg == "--no-checkpoint") {
+            checkpoint = false;
+        } else if (!batch && arg == "--warm-start" && i + 1 < argc) {
+            warm_start_filename = argv[++i];
+        } else if (batch && arg == "--jobs" && i + 1 < argc) {
+            batch_options.jobs = atoi(argv[++i]);
+        } else {
+            cerr << "Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+
+    signal(SIGINT, handleStopSignal);
+    signal(SIGTERM, handleStopSignal);
+
+    if (batch) {
+        return runBatchMode(argv[2], argv[3], batch_options);
+    }
+
     string input_filename = argv[1];
     string output_filename = argv[2];
 
@@ -20,27 +98,58 @@ int main(int argc, char* argv[]) {
         ProblemData problem = readInputData(input_filename);
         cout << "Successfully read input file: " << input_filename << endl;
 
+        // Read before the clock starts, like the input: a previous run's output, fitted to this instance by solve().
+        Solution warm_start;
+        if (!warm_start_filename.empty()) {
+            warm_start = readSolutionData(warm_start_filename);
+            options.warm_start = &warm_start;
+            cout << "Starting from the plan in " << warm_start_filename << endl;
+        }
+
         auto allowed_duration = chrono::milliseconds(long(problem.time_limit_minutes * 60 * 1000));
         auto start_time = chrono::steady_clock::now();
         auto deadline = start_time + allowed_duration;
 
         // 2. Solve the problem
-        Solution solution = solve(problem);
+        SolverStats stats;
+        Telemetry telemetry;
+        options.stats = &stats;
+        options.telemetry = &telemetry;
+        if (checkpoint) options.checkpoint_path = output_filename;
+        Solution solution = solve(problem, options);
         
         auto end_time = chrono::steady_clock::now();
         auto elapsed = chrono::duration_cast<chrono::milliseconds>(end_time - start_time);
-        cout << "Solver completed in " << elapsed.count() / 1000.0 << " seconds." << endl;
+        cout << "Solver completed in " << elapsed.count() / 1000.0 << " seconds (seed " << stats.seed << ")." << endl;
+        if (isfinite(stats.upper_bound)) {
+            cout << "Upper bound " << stats.upper_bound << ", optimality gap " << 100.0 * stats.optimality_gap << "%"
+                 << (stats.stopped_at_gap ? " (within tolerance; stopped early)." : ".") << endl;
+        } else {
+            cout << "Upper bound unavailable (not ready before the search ended, or the instance has none)." << endl;
+        }
+        if (options.iteration_budget > 0 && stats.deadline_reached) {
+            cerr << "Warning: the time limit ended the search before the iteration budget was used; this run is not reproducible." << endl;
+        }
 
-        if (end_time > deadline) {
+        if (end_time > deadline && !checkpoint) {
             cerr << "TimeLimitExceeded: Solver exceeded the time limit of " << problem.time_limit_minutes << " minutes." << endl;
             cout << "This instance will receive a score of 0." << endl;
             return 1;
         }
+        if (end_time > deadline) {
+            cout << "Finished " << (end_time - deadline) / chrono::milliseconds(1) << " ms after the time limit; the output file held the best checkpointed plan throughout." << endl;
+        }
 
-        // 3. Write the solution to the output file
-        writeOutputData(output_filename, solution);
+        // 3. Write the solution to the output file (with checkpoints on, solve() has already written it)
+        if (!checkpoint) {
+            writeOutputData(output_filename, solution, true);
+        }
         cout << "Successfully wrote solution to output file: " << output_filename << endl;
 
+        if (Telemetry::kEnabled) {
+            telemetry.writeJson(output_filename + ".stats.json");
+        }
+
     } catch (const runtime_error& e) {
         cerr << "An error occurred: " << e.what() << endl;
         return 1;
@@ -0,0 +1,47 @@
+#include "neighbor_lists.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+void NeighborLists::build(const ProblemData& problem, const VillageGrid& grid, int k, int num_threads) {
+    const int num_villages = static_cast<int>(problem.villages.size());
+    const int num_cities = static_cast<int>(problem.cities.size());
+    village_size_ = max(0, min(k, num_villages - 1));
+    city_size_ = max(0, min(k, num_villages));
+    village_lists_.assign(static_cast<size_t>(num_villages) * village_size_, -1);
+    city_lists_.assign(static_cast<size_t>(num_cities) * city_size_, -1);
+    if (village_size_ == 0 && city_size_ == 0) return;
+
+    // Villages [begin, end): one more neighbour than needed, so the village itself can be dropped.
+    auto fillVillages = [&](int begin, int end) {
+        vector<int> found;
+        for (int v = begin; v < end; ++v) {
+            grid.nearest(problem.villages[v].coords, village_size_ + 1, found);
+            int* list = village_lists_.data() + static_cast<size_t>(v) * village_size_;
+            int filled = 0;
+            for (int u : found) {
+                if (u != v && filled < village_size_) list[filled++] = u;
+            }
+        }
+    };
+
+    vector<int> found;
+    for (int c = 0; c < num_cities; ++c) {
+        grid.nearest(problem.cities[c], city_size_, found);
+        copy(found.begin(), found.end(), city_lists_.begin() + static_cast<size_t>(c) * city_size_);
+    }
+    if (village_size_ == 0) return;
+
+    num_threads = max(1, min(num_threads, num_villages / 1024 + 1));
+    if (num_threads == 1) {
+        fillVillages(0, num_villages);
+        return;
+    }
+    vector<thread> workers;
+    for (int t = 0; t < num_threads; ++t) {
+        workers.emplace_back(fillVillages, static_cast<int>(static_cast<long>(num_villages) * t / num_threads),
+                             static_cast<int>(static_cast<long>(num_villages) * (t + 1) / num_threads));
+    }
+    for (auto& w : workers) w.join();
+}
@@ -0,0 +1,39 @@
+#ifndef NEIGHBOR_LISTS_H
+#define NEIGHBOR_LISTS_H
+
+#include <vector>
+#include "structures.h"
+#include "spatial_index.h"
+
+/**
+ * @brief The k nearest villages of every village and of every city, computed once per instance.
+ *
+ * Lists are nearest first with ties broken by index, exactly as VillageGrid::nearest() orders
+ * them, and a village's list does not contain the village itself. Every village list has
+ * villageListSize() entries and every city list cityListSize() entries (k, or fewer on instances
+ * with fewer villages), stored back to back in one flat array each. Searches scan a list first
+ * and fall back to a full query only when nothing on it will do.
+ */
+class NeighborLists {
+public:
+    /**
+     * @brief Fills the lists from grid, which must hold every village of problem (nothing removed),
+     * splitting the villages over num_threads threads. k <= 0 leaves every list empty.
+     */
+    void build(const ProblemData& problem, const VillageGrid& grid, int k, int num_threads);
+
+    bool empty() const { return village_size_ == 0 && city_size_ == 0; }
+    int villageListSize() const { return village_size_; }
+    int cityListSize() const { return city_size_; }
+
+    const int* villageBegin(int village_idx) const { return village_lists_.data() + static_cast<size_t>(village_idx) * village_size_; }
+    const int* villageEnd(int village_idx) const { return villageBegin(village_idx) + village_size_; }
+    const int* cityBegin(int city_idx) const { return city_lists_.data() + static_cast<size_t>(city_idx) * city_size_; }
+    const int* cityEnd(int city_idx) const { return cityBegin(city_idx) + city_size_; }
+
+private:
+    int village_size_ = 0, city_size_ = 0;
+    std::vector<int> village_lists_, city_lists_;
+};
+
+#endif // NEIGHBOR_LISTS_H
@@ -0,0 +1,138 @@
+#include "payload.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+const int DRY = 0, PER = 1, OTH = 2;
+const double kEps = 1e-9;
+
+// Field widths of a cache key: capacity bucket, food need, other need.
+const int kBucketBits = 24, kFoodBits = 20, kOtherBits = 20;
+
+// Up to this many units of a type, every count is tried instead of only the vertices: rounding
+// matters most when few units fit.
+const int kEnumerateUpTo = 32;
+
+// Most units of weight w that fit cap, up to bound.
+int unitsFitting(double cap, double w, int bound) {
+    if (bound <= 0) return 0;
+    if (w <= kEps) return bound;
+    if (cap <= 0.0) return 0;
+    return static_cast<int>(min(static_cast<double>(bound), floor(cap / w)));
+}
+
+} // namespace
+
+PayloadOptimizer::PayloadOptimizer(const vector<PackageInfo>& packages) {
+    double lightest = 0.0;
+    for (int type = 0; type < 3; ++type) {
+        weight_[type] = packages[type].weight;
+        value_[type] = packages[type].value;
+        if (weight_[type] > kEps && (lightest == 0.0 || weight_[type] < lightest)) lightest = weight_[type];
+    }
+    quantum_ = lightest > 0.0 ? lightest / 64.0 : 1.0;
+}
+
+double PayloadOptimizer::value(const Payload& load) const {
+    return load.dry * value_[DRY] + load.perishable * value_[PER] + load.other * value_[OTH];
+}
+
+int PayloadOptimizer::foodVertices(double capacity, int food_need, int perishable[4]) const {
+    const int max_perishable = value_[PER] > 0.0 ? unitsFitting(capacity, weight_[PER], food_need) : 0;
+    perishable[0] = 0;
+    perishable[1] = max_perishable;
+    int count = 2;
+    // Where dry + perishable == food_need and the weight is exactly used up.
+    if (fabs(weight_[PER] - weight_[DRY]) > kEps) {
+        double crossing = (capacity - weight_[DRY] * food_need) / (weight_[PER] - weight_[DRY]);
+        if (crossing > 0.0 && crossing < max_perishable) {
+            perishable[count++] = static_cast<int>(crossing);
+            perishable[count++] = static_cast<int>(crossing) + 1;
+        }
+    }
+    return count;
+}
+
+int PayloadOptimizer::dryFitting(double capacity, int food_need, int perishable) const {
+    return value_[DRY] > 0.0 ? unitsFitting(capacity - perishable * weight_[PER], weight_[DRY], food_need - perishable) : 0;
+}
+
+void PayloadOptimizer::bestFood(double capacity, int food_need, int& dry, int& perishable) const {
+    dry = perishable = 0;
+    if (food_need <= 0 || capacity < 0.0) return;
+    int candidates[4];
+    const int count = foodVertices(capacity, food_need, candidates);
+    const bool enumerate = candidates[1] <= kEnumerateUpTo;
+    double best_value = -1.0;
+    for (int c = 0; c < (enumerate ? candidates[1] + 1 : count); ++c) {
+        int p = enumerate ? c : candidates[c];
+        int d = dryFitting(capacity, food_need, p);
+        double v = d * value_[DRY] + p * value_[PER];
+        if (v > best_value) {
+            best_value = v;
+            dry = d;
+            perishable = p;
+        }
+    }
+}
+
+Payload PayloadOptimizer::solve(double capacity, int food_need, int other_need) const {
+    const int other_bound = value_[OTH] > 0.0 ? other_need : 0;
+
+    // Other-supplies counts at the relaxation's vertices: none, as many as fit, or what fits
+    // beside each food vertex; one fewer than a fill can make room for a more valuable food unit.
+    int other_candidates[12] = {0, unitsFitting(capacity, weight_[OTH], other_bound)};
+    int num_other = 2;
+    int food_candidates[4];
+    const int num_food = food_need > 0 ? foodVertices(capacity, food_need, food_candidates) : 0;
+    for (int c = 0; c < num_food; ++c) {
+        int p = food_candidates[c];
+        int d = dryFitting(capacity, food_need, p);
+        int fill = unitsFitting(capacity - d * weight_[DRY] - p * weight_[PER], weight_[OTH], other_bound);
+        other_candidates[num_other++] = fill;
+        if (fill > 0) other_candidates[num_other++] = fill - 1;
+    }
+    if (other_candidates[1] > 0) other_candidates[num_other++] = other_candidates[1] - 1;
+
+    const bool enumerate = other_candidates[1] <= kEnumerateUpTo;
+    Payload best;
+    double best_value = -1.0;
+    for (int c = 0; c < (enumerate ? other_candidates[1] + 1 : num_other); ++c) {
+        Payload load;
+        load.other = enumerate ? c : other_candidates[c];
+        bestFood(capacity - load.other * weight_[OTH], food_need, load.dry, load.perishable);
+        double v = value(load);
+        if (v > best_value) {
+            best_value = v;
+            best = load;
+        }
+    }
+    return best;
+}
+
+Payload PayloadOptimizer::best(double capacity, int food_need, int other_need) {
+    food_need = max(0, food_need);
+    other_need = max(0, other_need);
+    if (capacity <= 0.0 || food_need + other_need == 0) return Payload();
+
+    // A capacity that rounding left just below a multiple of the quantum still gets that bucket,
+    // clamped so the answer never exceeds the checker's tolerance. A clamped bucket is solved
+    // for this capacity only, since its answer may not fit the other capacities of the bucket.
+    const double bucket = floor(capacity / quantum_ + 1e-9);
+    const double bucket_capacity = min(bucket * quantum_, capacity + 1e-9);
+    if (bucket_capacity < bucket * quantum_ || bucket >= double(uint64_t(1) << kBucketBits) || food_need >= (1 << kFoodBits) || other_need >= (1 << kOtherBits)) {
+        return solve(bucket_capacity, food_need, other_need);
+    }
+
+    const uint64_t key = (static_cast<uint64_t>(bucket) << (kFoodBits + kOtherBits)) | (static_cast<uint64_t>(food_need) << kOtherBits) | static_cast<uint64_t>(other_need);
+    auto it = memo_.find(key);
+    if (it != memo_.end()) return it->second;
+
+    if (memo_.size() >= kMaxEntries) memo_.clear();
+    Payload load = solve(bucket_capacity, food_need, other_need);
+    memo_.emplace(key, load);
+    return load;
+}
@@ -0,0 +1,56 @@
+#ifndef PAYLOAD_H
+#define PAYLOAD_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "structures.h"
+
+/**
+ * @brief Units of each package type in one drop.
+ */
+struct Payload {
+    int dry = 0, perishable = 0, other = 0;
+    bool empty() const { return dry + perishable + other == 0; }
+};
+
+/**
+ * @brief Memoized bounded knapsack over the three package types.
+ *
+ * best() returns the load of highest value that fits a weight capacity and a village's remaining
+ * need: dry + perishable <= food need, other <= other need. It depends only on the packages and on
+ * (capacity, food need, other need), so answers are cached per key. Capacities are rounded down to
+ * a multiple of quantum(), 1/64 of the lightest package, so every answer fits the capacity
+ * asked for (within the checker's 1e-9 tolerance) and nearby capacities share one entry. One optimizer per thread: best() is not
+ * thread-safe.
+ *
+ * Each entry is solved from the linear relaxation. The relaxed optimum lies on a vertex where the
+ * other-supplies count is 0, at its bound, or fills what food leaves, and the food mix is all dry,
+ * all perishable, or exactly fills both food need and the weight left. The integer neighbours of
+ * those vertices are priced and the best is kept. When only a few units of a type fit, where
+ * rounding moves the integer optimum furthest from the vertices, every count of it is tried.
+ */
+class PayloadOptimizer {
+public:
+    explicit PayloadOptimizer(const std::vector<PackageInfo>& packages);
+
+    Payload best(double capacity, int food_need, int other_need);
+
+    double quantum() const { return quantum_; }
+    size_t cachedEntries() const { return memo_.size(); }
+
+private:
+    static constexpr size_t kMaxEntries = size_t(1) << 20; // About 32 MiB; the cache restarts when full.
+
+    Payload solve(double capacity, int food_need, int other_need) const;
+    int foodVertices(double capacity, int food_need, int perishable[4]) const;
+    int dryFitting(double capacity, int food_need, int perishable) const;
+    void bestFood(double capacity, int food_need, int& dry, int& perishable) const;
+    double value(const Payload& load) const;
+
+    double weight_[3], value_[3];
+    double quantum_;
+    std::unordered_map<uint64_t, Payload> memo_;
+};
+
+#endif // PAYLOAD_H
@@ -0,0 +1,76 @@
+#include "portfolio.h"
+#include <algorithm>
+
+using namespace std;
+
+PortfolioScheduler::PortfolioScheduler(vector<const char*> arm_names) {
+    for (const char* name : arm_names) {
+        Arm arm;
+        arm.name = name;
+        arms_.push_back(arm);
+    }
+}
+
+int PortfolioScheduler::choose() {
+    lock_guard<mutex> lock(mutex_);
+    for (size_t a = 0; a < arms_.size(); ++a) {
+        if (arms_[a].started == 0) {
+            arms_[a].started++;
+            return static_cast<int>(a);
+        }
+    }
+
+    double total_seconds = 0.0;
+    for (const auto& arm : arms_) total_seconds += arm.recent_share;
+
+    // Arms whose first pull is still running have no history yet and are not chosen again until it ends.
+    int starved = -1, fastest = -1;
+    double starved_share = kMinShare, best_rate = -1.0;
+    for (size_t a = 0; a < arms_.size(); ++a) {
+        const Arm& arm = arms_[a];
+        if (arm.pulls == 0) continue;
+        const double share = arm.recent_share / total_seconds;
+        if (share < starved_share) {
+            starved_share = share;
+            starved = static_cast<int>(a);
+        }
+        const double rate = arm.rate_gain / arm.rate_seconds;
+        if (rate > best_rate) {
+            best_rate = rate;
+            fastest = static_cast<int>(a);
+        }
+    }
+    const int chosen = starved >= 0 ? starved : max(fastest, 0);
+    arms_[chosen].started++;
+    return chosen;
+}
+
+double PortfolioScheduler::report(int arm, double gain, double seconds) {
+    lock_guard<mutex> lock(mutex_);
+    for (auto& a : arms_) a.recent_share *= kShareDiscount;
+    Arm& pulled = arms_[arm];
+    gain = max(0.0, gain);
+    seconds = max(seconds, 1e-6);
+    pulled.pulls++;
+    pulled.total_gain += gain;
+    pulled.total_seconds += seconds;
+    pulled.recent_share += seconds;
+    pulled.rate_gain = pulled.rate_gain * kRateDiscount + gain;
+    pulled.rate_seconds = pulled.rate_seconds * kRateDiscount + seconds;
+    return pulled.rate_gain / pulled.rate_seconds;
+}
+
+long PortfolioScheduler::pulls(int arm) const {
+    lock_guard<mutex> lock(mutex_);
+    return arms_[arm].pulls;
+}
+
+double PortfolioScheduler::seconds(int arm) const {
+    lock_guard<mutex> lock(mutex_);
+    return arms_[arm].total_seconds;
+}
+
+double PortfolioScheduler::gain(int arm) const {
+    lock_guard<mutex> lock(mutex_);
+    return arms_[arm].total_gain;
+}
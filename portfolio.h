@@ -0,0 +1,60 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Shares the search time between strategies ("arms") by how fast each has recently been
+ * raising the best value.
+ *
+ * Workers ask choose() for an arm, run one pull of it (a construction pass, a short ratio walk,
+ * a slice of ALNS, ...) and report() the improvement of the best value it made and the time it
+ * took. Every arm is pulled once first. After that the arm with the highest recent rate of
+ * improvement per second is chosen, except that an arm whose share of the recent time has fallen
+ * below kMinShare is pulled first: exploration costs about that share of the budget per arm,
+ * however long the arm's pulls take. Rates are discounted over each arm's own pulls, so an arm
+ * that stops paying off (construction once ALNS has overtaken it) loses the lead within a pull
+ * or two, and one that starts paying off again wins it back on its next exploratory pull.
+ * Thread-safe; one scheduler is shared by all workers.
+ */
+class PortfolioScheduler {
+public:
+    explicit PortfolioScheduler(std::vector<const char*> arm_names);
+
+    /**
+     * @brief The arm to pull next. Ties go to the lower index.
+     */
+    int choose();
+
+    /**
+     * @brief Records a pull of arm that raised the best value by gain in seconds of work.
+     * @return The arm's recent rate of improvement after the pull, in value per second.
+     */
+    double report(int arm, double gain, double seconds);
+
+    int numArms() const { return static_cast<int>(arms_.size()); }
+    const char* name(int arm) const { return arms_[arm].name; }
+    long pulls(int arm) const;
+    double seconds(int arm) const;
+    double gain(int arm) const;
+
+private:
+    struct Arm {
+        const char* name;
+        long started = 0;          // Pulls handed out, including those still running.
+        long pulls = 0;            // Pulls reported.
+        double total_seconds = 0.0, total_gain = 0.0;
+        double rate_gain = 0.0, rate_seconds = 0.0; // Over the arm's own pulls, discounted by kRateDiscount.
+        double recent_share = 0.0;                  // Seconds over every arm's pulls, discounted by kShareDiscount.
+    };
+
+    static constexpr double kRateDiscount = 0.5;   // Per pull of the arm: its rate follows its last few pulls.
+    static constexpr double kShareDiscount = 0.97; // Per pull of any arm.
+    static constexpr double kMinShare = 0.01;      // Of the recent time, below which an arm is explored.
+
+    mutable std::mutex mutex_;
+    std::vector<Arm> arms_;
+};
+
+#endif // PORTFOLIO_H
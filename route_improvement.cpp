@@ -0,0 +1,111 @@
+#include "route_improvement.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+const double kMinGain = 1e-9;
+const int kMaxPasses = 1000;
+const int kMaxOrOptSegment = 3;
+
+/**
+ * @brief Closed tour home -> drops[tour[0]] -> ... -> drops[tour[n-1]] -> home.
+ */
+class TourView {
+public:
+    TourView(const DistanceCache& dist, int city_idx, const vector<Drop>& drops, vector<int>& tour)
+        : dist_(dist), city_idx_(city_idx), drops_(drops), tour_(tour) {}
+
+    int size() const { return static_cast<int>(tour_.size()); }
+
+    // Village index at tour position k, where -1 and size() both denote the home city.
+    int node(int k) const { return (k < 0 || k >= size()) ? -1 : drops_[tour_[k]].village_id - 1; }
+
+    double d(int a, int b) const {
+        if (a < 0 && b < 0) return 0.0;
+        if (a < 0) return dist_.cityToVillage(city_idx_, b);
+        if (b < 0) return dist_.cityToVillage(city_idx_, a);
+        return dist_.villageToVillage(a, b);
+    }
+
+    /**
+     * @brief Applies the first improving segment reversal found.
+     */
+    bool twoOpt() {
+        const int n = size();
+        for (int i = 0; i + 1 < n; ++i) {
+            int a = node(i - 1), b = node(i);
+            double d_ab = d(a, b);
+            for (int j = i + 1; j < n; ++j) {
+                int c = node(j), e = node(j + 1);
+                double delta = d(a, c) + d(b, e) - d_ab - d(c, e);
+                if (delta < -kMinGain) {
+                    reverse(tour_.begin() + i, tour_.begin() + j + 1);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Applies the first improving relocation of a 1..3 village segment, possibly reversed.
+     */
+    bool orOpt() {
+        const int n = size();
+        for (int len = 1; len <= kMaxOrOptSegment && len < n; ++len) {
+            for (int i = 0; i + len <= n; ++i) {
+                int s0 = node(i), s1 = node(i + len - 1);
+                int prev = node(i - 1), next = node(i + len);
+                double removal_gain = d(prev, s0) + d(s1, next) - d(prev, next);
+                if (removal_gain <= kMinGain) continue;
+
+                // Candidate edges (node(k), node(k+1)) that do not touch the segment.
+                for (int k = -1; k < n; ++k) {
+                    if (k >= i - 1 && k <= i + len - 1) continue;
+                    int p = node(k), q = node(k + 1);
+                    double d_pq = d(p, q);
+                    double forward = d(p, s0) + d(s1, q) - d_pq;
+                    double backward = d(p, s1) + d(s0, q) - d_pq;
+                    bool reversed = backward < forward;
+                    if (min(forward, backward) - removal_gain < -kMinGain) {
+                        vector<int> segment(tour_.begin() + i, tour_.begin() + i + len);
+                        if (reversed) std::reverse(segment.begin(), segment.end());
+                        tour_.erase(tour_.begin() + i, tour_.begin() + i + len);
+                        int insert_at = (k < i) ? k + 1 : k + 1 - len;
+                        tour_.insert(tour_.begin() + insert_at, segment.begin(), segment.end());
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    const DistanceCache& dist_;
+    int city_idx_;
+    const vector<Drop>& drops_;
+    vector<int>& tour_;
+};
+
+} // namespace
+
+double improveTripRoute(const DistanceCache& dist, int city_idx, vector<Drop>& drops) {
+    if (drops.size() < 3) return dist.tripDistance(city_idx, drops);
+
+    vector<int> tour(drops.size());
+    for (size_t i = 0; i < drops.size(); ++i) tour[i] = static_cast<int>(i);
+
+    TourView view(dist, city_idx, drops, tour);
+    for (int pass = 0; pass < kMaxPasses; ++pass) {
+        if (!view.twoOpt() && !view.orOpt()) break;
+    }
+
+    vector<Drop> reordered;
+    reordered.reserve(drops.size());
+    for (int pos : tour) reordered.push_back(drops[pos]);
+    drops.swap(reordered);
+    return dist.tripDistance(city_idx, drops);
+}
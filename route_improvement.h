@@ -0,0 +1,22 @@
+#ifndef ROUTE_IMPROVEMENT_H
+#define ROUTE_IMPROVEMENT_H
+
+#include <vector>
+#include "structures.h"
+#include "distance_cache.h"
+
+/**
+ * @brief Re-sequences a trip's drops with 2-opt and Or-opt moves until no improving move remains.
+ *
+ * The tour starts and ends at the home city. Every move is priced in O(1) from the distance
+ * cache, and only strictly shortening moves (by more than 1e-9) are applied. Drops keep their
+ * loads, so pickups, weight and (for trips visiting each village once) delivered value are unchanged.
+ *
+ * @param dist Distance cache of the problem.
+ * @param city_idx 0-based index of the trip's home city.
+ * @param drops The trip's drops, re-ordered in place.
+ * @return The closed-tour length after improvement.
+ */
+double improveTripRoute(const DistanceCache& dist, int city_idx, vector<Drop>& drops);
+
+#endif // ROUTE_IMPROVEMENT_H
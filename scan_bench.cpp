@@ -0,0 +1,132 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdlib>
+
+#include "structures.h"
+#include "distance_cache.h"
+#include "instance_generator.h"
+#include "village_scan.h"
+
+using namespace std;
+
+/**
+ * @brief Microbenchmark and cross-check of the first-village scan kernels.
+ *
+ * Builds a synthetic instance in which every other village duplicates its neighbour (same
+ * coordinates and population, so equal net values are common), then runs random scans - random
+ * helicopter, dry ratio, DMax budget, remaining demand and candidate subset in grid-like
+ * shuffled order - through the scalar and the AVX2 kernel. Exits non-zero if any result differs.
+ * Usage: scan_bench [num_villages] [scans]
+ */
+
+struct ScanCase {
+    FirstVillageScan scan;
+    vector<int> candidates;
+};
+
+static bool sameChoice(const FirstVillageChoice& a, const FirstVillageChoice& b) {
+    return a.village == b.village && a.net_value == b.net_value && a.dry == b.dry && a.perishable == b.perishable && a.other == b.other;
+}
+
+template <typename Kernel>
+static double timeKernel(const vector<ScanCase>& cases, int reps, Kernel kernel, long& checksum) {
+    auto start = chrono::steady_clock::now();
+    checksum = 0;
+    for (int r = 0; r < reps; ++r) {
+        for (const auto& c : cases) checksum += kernel(c.scan, c.candidates.data(), c.candidates.size()).village;
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int num_villages = argc > 1 ? atoi(argv[1]) : 20000;
+    int num_scans = argc > 2 ? atoi(argv[2]) : 2000;
+
+    GeneratorParams params;
+    params.num_villages = num_villages;
+    params.seed = 7;
+    ProblemData problem = generateInstance(params);
+    for (int i = 1; i < num_villages; i += 2) {
+        problem.villages[i].coords = problem.villages[i - 1].coords;
+        problem.villages[i].population = problem.villages[i - 1].population;
+    }
+    DistanceCache dist(problem);
+
+    vector<int> population(num_villages);
+    for (int i = 0; i < num_villages; ++i) population[i] = problem.villages[i].population;
+
+    // Shared remaining demand: some villages served, some partly, some untouched.
+    mt19937 gen(11);
+    vector<int> rem_food(num_villages), rem_other(num_villages);
+    for (int i = 0; i < num_villages; ++i) {
+        switch (gen() % 4) {
+            case 0: rem_food[i] = 0; rem_other[i] = 0; break;
+            case 1: rem_food[i] = static_cast<int>(gen() % (9 * population[i] + 1)); rem_other[i] = 0; break;
+            case 2: rem_food[i] = 0; rem_other[i] = static_cast<int>(gen() % (population[i] + 1)); break;
+            default: rem_food[i] = 9 * population[i]; rem_other[i] = population[i]; break;
+        }
+    }
+
+    uniform_real_distribution<> unit(0.0, 1.0);
+    vector<ScanCase> cases(num_scans);
+    long total_candidates = 0;
+    for (auto& c : cases) {
+        const Helicopter& heli = problem.helicopters[gen() % problem.helicopters.size()];
+        const double ratio = (gen() % 8 == 0) ? static_cast<double>(gen() % 2) : unit(gen);
+        c.scan.city_distance = dist.cityRow(heli.home_city_id - 1);
+        c.scan.population = population.data();
+        c.scan.rem_food = rem_food.data();
+        c.scan.rem_other = rem_other.data();
+        c.scan.packages = problem.packages.data();
+        c.scan.weight_capacity = heli.weight_capacity * (gen() % 4 == 0 ? unit(gen) : 1.0);
+        c.scan.distance_capacity = heli.distance_capacity;
+        c.scan.distance_budget = problem.d_max * unit(gen);
+        c.scan.fixed_cost = heli.fixed_cost;
+        c.scan.alpha = heli.alpha;
+        c.scan.dry_ratio = ratio;
+        c.scan.avg_food_weight = ratio * problem.packages[0].weight + (1.0 - ratio) * problem.packages[1].weight;
+
+        // A contiguous run of village indices, shuffled: candidates come out of the grid in cell order.
+        int size = 1 + static_cast<int>(gen() % 2000);
+        int first = static_cast<int>(gen() % num_villages);
+        for (int k = 0; k < size; ++k) c.candidates.push_back((first + k) % num_villages);
+        shuffle(c.candidates.begin(), c.candidates.end(), gen);
+        total_candidates += size;
+    }
+
+    const bool has_avx2 = firstVillageScanHasAvx2();
+    cout << "villages=" << num_villages << " scans=" << num_scans << " candidates=" << total_candidates
+         << " avx2=" << (has_avx2 ? "yes" : "no") << endl;
+
+    int mismatches = 0, chosen = 0;
+    for (const auto& c : cases) {
+        FirstVillageChoice scalar = scanFirstVillageScalar(c.scan, c.candidates.data(), c.candidates.size());
+        FirstVillageChoice dispatched = scanFirstVillage(c.scan, c.candidates.data(), c.candidates.size());
+        if (scalar.village != -1) ++chosen;
+        if (!sameChoice(scalar, dispatched)) {
+            if (++mismatches <= 5) {
+                cerr << "MISMATCH: scalar village " << scalar.village << " net " << scalar.net_value
+                     << ", dispatched village " << dispatched.village << " net " << dispatched.net_value << endl;
+            }
+        }
+    }
+    cout << "cross-check: " << num_scans - mismatches << "/" << num_scans << " scans agree (" << chosen << " found a village)" << endl;
+
+    const int reps = 20;
+    const double evaluations = static_cast<double>(reps) * total_candidates;
+    long scalar_sum = 0, dispatched_sum = 0;
+    double scalar_ms = timeKernel(cases, reps, scanFirstVillageScalar, scalar_sum);
+    double dispatched_ms = timeKernel(cases, reps, scanFirstVillage, dispatched_sum);
+    cout << "scalar    : " << scalar_ms << " ms (" << evaluations / scalar_ms / 1e3 << " M candidates/s)" << endl;
+    cout << "dispatched: " << dispatched_ms << " ms (" << evaluations / dispatched_ms / 1e3 << " M candidates/s)" << endl;
+    cout << "speedup   : " << scalar_ms / dispatched_ms << "x" << endl;
+
+    if (mismatches > 0 || scalar_sum != dispatched_sum) {
+        cerr << "MISMATCH: " << mismatches << " scans differ" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "scoring.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+string describeViolation(const Violation& violation) {
+    ostringstream out;
+    switch (violation.kind) {
+    case ViolationKind::INVALID_HELICOPTER:
+        out << "Invalid helicopter ID " << violation.helicopter_id;
+        break;
+    case ViolationKind::INVALID_VILLAGE:
+        out << "Heli " << violation.helicopter_id << ", Trip " << violation.trip_index + 1 << ": Invalid village ID " << violation.village_id;
+        break;
+    case ViolationKind::WEIGHT_CAPACITY:
+        out << "Heli " << violation.helicopter_id << ", Trip " << violation.trip_index + 1 << " exceeds weight capacity (" << violation.amount << " > " << violation.limit << ").";
+        break;
+    case ViolationKind::OVER_DROP:
+        out << "Heli " << violation.helicopter_id << ", Trip " << violation.trip_index + 1 << " drops more packages than picked up.";
+        break;
+    case ViolationKind::TRIP_DISTANCE:
+        out << "Heli " << violation.helicopter_id << ", Trip " << violation.trip_index + 1 << " exceeds trip distance capacity (" << violation.amount << " > " << violation.limit << ").";
+        break;
+    case ViolationKind::DMAX_EXCEEDED:
+        out << "Heli " << violation.helicopter_id << " exceeds DMax (" << violation.amount << " > " << violation.limit << ").";
+        break;
+    }
+    return out.str();
+}
+
+SolutionScorer::SolutionScorer(const ProblemData& problem, const DistanceCache& dist)
+    : problem_(problem), dist_(dist),
+      food_delivered_(problem.villages.size(), 0.0),
+      other_delivered_(problem.villages.size(), 0.0),
+      village_value_(problem.villages.size(), 0.0),
+      helicopter_distance_(problem.helicopters.size(), 0.0),
+      is_touched_(problem.villages.size(), 0) {}
+
+double SolutionScorer::checkTrip(int heli_idx, int trip_index, const Trip& trip, vector<Violation>& violations) const {
+    const auto& helicopter = problem_.helicopters[heli_idx];
+    const int home_city_idx = helicopter.home_city_id - 1;
+    const int num_villages = static_cast<int>(problem_.villages.size());
+
+    double trip_weight = (trip.dry_food_pickup * problem_.packages[0].weight) + (trip.perishable_food_pickup * problem_.packages[1].weight) + (trip.other_supplies_pickup * problem_.packages[2].weight);
+    if (trip_weight > helicopter.weight_capacity + 1e-9) {
+        violations.push_back({ViolationKind::WEIGHT_CAPACITY, helicopter.id, trip_index, 0, trip_weight, helicopter.weight_capacity});
+    }
+
+    int current_village_idx = -1; // -1 while still at the home city
+    double trip_distance = 0.0;
+    int total_d_dropped = 0, total_p_dropped = 0, total_o_dropped = 0;
+    for (const auto& drop : trip.drops) {
+        total_d_dropped += drop.dry_food; total_p_dropped += drop.perishable_food; total_o_dropped += drop.other_supplies;
+        if (drop.village_id <= 0 || drop.village_id > num_villages) {
+            violations.push_back({ViolationKind::INVALID_VILLAGE, helicopter.id, trip_index, drop.village_id, 0.0, 0.0});
+            continue;
+        }
+        int village_idx = drop.village_id - 1;
+        trip_distance += (current_village_idx < 0) ? dist_.cityToVillage(home_city_idx, village_idx) : dist_.villageToVillage(current_village_idx, village_idx);
+        current_village_idx = village_idx;
+    }
+
+    if (total_d_dropped > trip.dry_food_pickup || total_p_dropped > trip.perishable_food_pickup || total_o_dropped > trip.other_supplies_pickup) {
+        violations.push_back({ViolationKind::OVER_DROP, helicopter.id, trip_index, 0, 0.0, 0.0});
+    }
+
+    if (current_village_idx >= 0) trip_distance += dist_.cityToVillage(home_city_idx, current_village_idx);
+    if (trip_distance > helicopter.distance_capacity + 1e-9) {
+        violations.push_back({ViolationKind::TRIP_DISTANCE, helicopter.id, trip_index, 0, trip_distance, helicopter.distance_capacity});
+    }
+    return trip_distance;
+}
+
+// Value Capping Logic, operation for operation as in format_checker.
+void SolutionScorer::addDropValue(int village_idx, const Drop& drop) {
+    if (!is_touched_[village_idx]) {
+        is_touched_[village_idx] = 1;
+        touched_.push_back(village_idx);
+    }
+    const auto& village = problem_.villages[village_idx];
+    const int vd = drop.dry_food, vp = drop.perishable_food, vo = drop.other_supplies;
+
+    double max_food_needed = village.population * 9.0;
+    double food_room_left = max(0.0, max_food_needed - food_delivered_[village_idx]);
+    double food_in_this_drop = vd + vp;
+    double effective_food_this_drop = min(food_in_this_drop, food_room_left);
+    double effective_vp = min((double)vp, effective_food_this_drop);
+    double value_from_p = effective_vp * problem_.packages[1].value;
+    double remaining_effective_food = effective_food_this_drop - effective_vp;
+    double effective_vd = min((double)vd, remaining_effective_food);
+    double value_from_d = effective_vd * problem_.packages[0].value;
+    village_value_[village_idx] += value_from_p + value_from_d;
+
+    double max_other_needed = village.population * 1.0;
+    double other_room_left = max(0.0, max_other_needed - other_delivered_[village_idx]);
+    double effective_vo = min((double)vo, other_room_left);
+    village_value_[village_idx] += effective_vo * problem_.packages[2].value;
+
+    food_delivered_[village_idx] += food_in_this_drop;
+    other_delivered_[village_idx] += vo;
+}
+
+ScoreReport SolutionScorer::score(const Solution& solution) {
+    ScoreReport report;
+    const int num_helicopters = static_cast<int>(problem_.helicopters.size());
+    const int num_villages = static_cast<int>(problem_.villages.size());
+    fill(helicopter_distance_.begin(), helicopter_distance_.end(), 0.0);
+
+    for (const auto& plan : solution) {
+        if (plan.helicopter_id <= 0 || plan.helicopter_id > num_helicopters) {
+            report.violations.push_back({ViolationKind::INVALID_HELICOPTER, plan.helicopter_id, -1, 0, 0.0, 0.0});
+            continue;
+        }
+        const int heli_idx = plan.helicopter_id - 1;
+        const auto& helicopter = problem_.helicopters[heli_idx];
+
+        for (size_t i = 0; i < plan.trips.size(); ++i) {
+            const Trip& trip = plan.trips[i];
+            double trip_distance = checkTrip(heli_idx, static_cast<int>(i), trip, report.violations);
+            for (const auto& drop : trip.drops) {
+                if (drop.village_id > 0 && drop.village_id <= num_villages) addDropValue(drop.village_id - 1, drop);
+            }
+            helicopter_distance_[heli_idx] += trip_distance;
+            double trip_cost = !trip.drops.empty() ? (helicopter.fixed_cost + (helicopter.alpha * trip_distance)) : 0;
+            report.total_cost += trip_cost;
+        }
+
+        if (helicopter_distance_[heli_idx] > problem_.d_max + 1e-9) {
+            report.violations.push_back({ViolationKind::DMAX_EXCEEDED, helicopter.id, -1, 0, helicopter_distance_[heli_idx], problem_.d_max});
+        }
+    }
+
+    // The checker sums village values in village order; untouched villages contribute exactly zero.
+    sort(touched_.begin(), touched_.end());
+    for (int v : touched_) {
+        report.total_value += village_value_[v];
+        food_delivered_[v] = other_delivered_[v] = village_value_[v] = 0.0;
+        is_touched_[v] = 0;
+    }
+    touched_.clear();
+
+    report.objective = report.total_value - report.total_cost;
+    return report;
+}
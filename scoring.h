@@ -0,0 +1,92 @@
+#ifndef SCORING_H
+#define SCORING_H
+
+#include <string>
+#include <vector>
+#include "structures.h"
+#include "distance_cache.h"
+
+/**
+ * @brief Kind of constraint a solution breaks. Invalid IDs make the grader reject the file outright;
+ * the others are reported per trip (or per helicopter for DMAX_EXCEEDED).
+ */
+enum class ViolationKind {
+    INVALID_HELICOPTER,
+    INVALID_VILLAGE,
+    WEIGHT_CAPACITY,
+    OVER_DROP,
+    TRIP_DISTANCE,
+    DMAX_EXCEEDED
+};
+
+/**
+ * @brief One broken constraint. trip_index is 0-based within its plan, or -1 for plan-level
+ * violations. For capacity violations, amount is the value that exceeded limit.
+ */
+struct Violation {
+    ViolationKind kind;
+    int helicopter_id;
+    int trip_index;
+    int village_id;
+    double amount;
+    double limit;
+};
+
+/**
+ * @brief Result of scoring a solution.
+ */
+struct ScoreReport {
+    double total_value = 0.0;
+    double total_cost = 0.0;
+    double objective = 0.0;
+    std::vector<Violation> violations;
+
+    bool feasible() const { return violations.empty(); }
+    // What format_checker prints as the final score: the objective, or -1 if any constraint is violated.
+    double score() const { return feasible() ? objective : -1.0; }
+};
+
+/**
+ * @brief Human-readable description of a violation, in the wording of format_checker.
+ */
+std::string describeViolation(const Violation& violation);
+
+/**
+ * @brief In-memory implementation of the grader's verification and scoring rules.
+ *
+ * Drops are applied in plan order, then trip order, then drop order, with value capped at each
+ * village's remaining need exactly as in format_checker, and totals are summed in the same order,
+ * so score() is bit-identical to the checker's result for the written file. A scorer keeps its
+ * per-village buffers between calls and resets only what the last solution touched; it is not
+ * thread-safe, so give each thread its own.
+ */
+class SolutionScorer {
+public:
+    SolutionScorer(const ProblemData& problem, const DistanceCache& dist);
+
+    /**
+     * @brief Scores a complete solution and lists every violated constraint.
+     */
+    ScoreReport score(const Solution& solution);
+
+    /**
+     * @brief Checks one trip of a helicopter in isolation (capacities and pickups, not DMax).
+     * @param heli_idx 0-based helicopter index.
+     * @param trip_index Position reported in violations.
+     * @param violations Receives the trip's violations, if any.
+     * @return The trip's closed-tour distance.
+     */
+    double checkTrip(int heli_idx, int trip_index, const Trip& trip, std::vector<Violation>& violations) const;
+
+private:
+    void addDropValue(int village_idx, const Drop& drop);
+
+    const ProblemData& problem_;
+    const DistanceCache& dist_;
+    std::vector<double> food_delivered_, other_delivered_, village_value_;
+    std::vector<double> helicopter_distance_;
+    std::vector<int> touched_;
+    std::vector<char> is_touched_;
+};
+
+#endif // SCORING_H
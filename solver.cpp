@@ -1,10 +1,34 @@
 #include "solver.h"
+#include "distance_cache.h"
+#include "spatial_index.h"
+#include "deadline.h"
+#include "evaluator.h"
+#include "route_improvement.h"
+#include "alns.h"
+#include "scoring.h"
+#include "telemetry.h"
+#include "checkpoint.h"
+#include "village_scan.h"
+#include "flat_solution.h"
+#include "payload.h"
+#include "decomposition.h"
+#include "warm_start.h"
+#include "portfolio.h"
+#include "neighbor_lists.h"
+#include "active_set.h"
+#include "upper_bound.h"
 #include <iostream>
 #include <chrono>
 #include <limits>
 #include <algorithm>
 #include <vector>
 #include <random>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
 
 using namespace std;
 
@@ -12,387 +36,597 @@ const int DRY = 0, PER = 1, OTH = 2;
 
 
 double calculateVillageValue(const Village& village, int dry_delivered, int perishable_delivered, int other_delivered,const vector<PackageInfo>& packages) {
-    int max_food_needed = 9 * village.population;
-    int max_other_needed = village.population;
-    
-    int total_food_delivered = dry_delivered + perishable_delivered;
-    int effective_food = min(total_food_delivered, max_food_needed);
-    int effective_other = min(other_delivered, max_other_needed);
-    
-    double food_value = 0;
-    if (effective_food > 0) {
-        int effective_perishable = min(perishable_delivered, effective_food);
-        food_value += effective_perishable * packages[PER].value;
-        
-        int remaining_food_need = effective_food - effective_perishable;
-        int effective_dry = min(dry_delivered, remaining_food_need);
-        food_value += effective_dry * packages[DRY].value;
-    }
-    
-    double other_value = effective_other * packages[OTH].value;
-    return food_value + other_value;
+    return villageDeliveryValue(village.population, dry_delivered, perishable_delivered, other_delivered, packages.data());
 }
 
-Solution solve(const ProblemData& problem) {
-
-    auto start_time = chrono::steady_clock::now();
-    auto allowed_duration = chrono::milliseconds(long(problem.time_limit_minutes * 60 * 1000));
-    auto safe_duration = chrono::duration_cast<chrono::milliseconds>(allowed_duration * 95 / 100);
-    auto deadline = start_time + safe_duration;
-    
-
-    Solution best_global_solution;
-    double best_value = -numeric_limits<double>::max();
-
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_real_distribution<> dis(0.0, 1.0);
+/**
+ * @brief Best solution found so far, shared by all search workers.
+ * The value is published through an atomic so losing candidates are rejected without taking the lock.
+ * A winning candidate is swapped in rather than copied. Each new best is also passed to the
+ * checkpoint writer, if there is one: the copy it needs is made before taking the lock, so only
+ * an O(1) hand-over happens while other workers wait.
+ */
+class BestSolutionSlot {
+public:
+    explicit BestSolutionSlot(Telemetry* telemetry = nullptr, CheckpointWriter* checkpoint = nullptr)
+        : best_value_(-numeric_limits<double>::max()), telemetry_(telemetry), checkpoint_(checkpoint) {}
+
+    double value() const { return best_value_.load(memory_order_acquire); }
+
+    /**
+     * @brief Installs the candidate if it beats the current best.
+     * @param candidate On success, swapped with the previous best, whose buffers the caller can
+     *        clear and build the next candidate into.
+     * @param improvement Set to the margin by which the previous best was beaten.
+     * @param source Search that found the candidate, for the telemetry trace.
+     * @return True if the candidate became the new best.
+     */
+    bool offer(double value, FlatSolution& candidate, double& improvement, const char* source = "") {
+        if (value <= best_value_.load(memory_order_acquire)) return false;
+        static thread_local FlatSolution checkpoint_copy;
+        if (checkpoint_) checkpoint_copy = candidate;
+        lock_guard<mutex> lock(mutex_);
+        double current = best_value_.load(memory_order_relaxed);
+        if (value <= current) return false;
+        improvement = value - current;
+        solution_.swap(candidate);
+        best_value_.store(value, memory_order_release);
+        if (telemetry_) telemetry_->recordBest(value, source);
+        if (checkpoint_) checkpoint_->publish(checkpoint_copy);
+        return true;
+    }
 
-    vector<double> starting_ratios = {0.1, 0.3, 0.5, 0.7, 0.9};
-    
-    for (double start_ratio : starting_ratios) {
-        if (chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count() <= 0) break;
-        
-        
-        double dry_ratio = start_ratio;
-        double perishable_ratio = 1.0 - start_ratio;
-        double learning_rate = 0.2;
-        int direction = 1; 
-
-        double previous_value = -numeric_limits<double>::max();
-        bool first_iteration = true;
-        int no_imp_count = 0;
-        const int max_no_improvement = 20; 
-        const double min_imp_threshold = 0.01;
-        
-        double temperature = 100.0;
-        double cooling_rate = 0.95;
+    Solution snapshot() {
+        lock_guard<mutex> lock(mutex_);
+        return solution_.toSolution();
+    }
 
-        while (true) {
-            auto current_time = chrono::steady_clock::now();
-            if (chrono::duration_cast<chrono::milliseconds>(deadline - current_time).count() <= 0) {
-                break;
-            }
+    FlatSolution take() {
+        lock_guard<mutex> lock(mutex_);
+        return move(solution_);
+    }
 
-            Solution current_solution;
-            current_solution.reserve(problem.helicopters.size());
+private:
+    atomic<double> best_value_;
+    Telemetry* telemetry_;
+    CheckpointWriter* checkpoint_;
+    mutex mutex_;
+    FlatSolution solution_;
+};
+
+/**
+ * @brief The classic five starting ratios, extended with evenly spaced extra ratios
+ * when more workers are available than there are classic starts.
+ */
+static vector<double> buildStartingRatios(int num_workers) {
+    vector<double> ratios = {0.1, 0.3, 0.5, 0.7, 0.9};
+    int extra = num_workers - static_cast<int>(ratios.size());
+    for (int i = 0; i < extra; ++i) {
+        ratios.push_back((i + 0.5) / extra);
+    }
+    return ratios;
+}
 
-            vector<int> rem_food_demand(problem.villages.size());
-            vector<int> rem_other_demand(problem.villages.size());
-            for (size_t i = 0; i < problem.villages.size(); ++i) {
-                rem_food_demand[i] = 9 * problem.villages[i].population;
-                rem_other_demand[i] = problem.villages[i].population;
-            }
+/**
+ * @brief Work done by all workers, for SolverStats.
+ */
+struct WorkCounters {
+    atomic<long> construction_passes{0};
+    atomic<long> alns_iterations{0};
+};
+
+/**
+ * @brief Read-only state shared by every search worker, plus the shared work counters.
+ */
+struct SearchContext {
+    const ProblemData& problem;
+    const SolverOptions& options;
+    const DistanceCache& dist;
+    const VillageGrid& grid;
+    const NeighborLists& neighbors;
+    const Deadline& deadline;
+    WorkCounters& counters;
+};
+
+/**
+ * @brief Derives the seed of one random stream (a worker or a start) from the run's seed.
+ */
+static const unsigned kStartStreamBase = 1u << 20; // Start streams follow the (fewer) worker streams.
+static const unsigned kRegionStreamBase = 2u << 20;
+static const unsigned kRepairStream = 3u << 20;
+
+static unsigned deriveSeed(unsigned base_seed, unsigned stream) {
+    seed_seq seq = {base_seed, stream};
+    unsigned seed;
+    seq.generate(&seed, &seed + 1);
+    return seed;
+}
 
-            for (const auto& helicopter : problem.helicopters) {
-                auto now_h = chrono::steady_clock::now();
-                if (chrono::duration_cast<chrono::milliseconds>(deadline - now_h).count() <= 0) break;
-                
-                HelicopterPlan plan;
-                plan.helicopter_id = helicopter.id;
-                const Point& home = problem.cities[helicopter.home_city_id - 1];
+/**
+ * @brief How one call of runConstruction builds its plans.
+ */
+struct ConstructionSettings {
+    double start_ratio = 0.5;
+    bool ratio_walk = false; // Loads from the dry/perishable ratio walk instead of the payload optimizer.
+    long max_passes = 0;     // Ends the walk after this many passes even if it has not stalled; 0 = no cap.
+    const vector<int>* helicopter_order = nullptr; // Order the helicopters take villages in; null = roster order.
+};
+
+/**
+ * @brief Runs the adaptive dry/perishable ratio walk from a single starting ratio,
+ * offering every constructed solution to best_slot. The walk stops once it has gone
+ * max_no_improvement passes without raising that slot's value. Without settings.ratio_walk,
+ * loads come from the payload optimizer instead and a single pass is built.
+ * @return The sum of the margins by which this call raised best_slot's value.
+ */
+static double runConstruction(const SearchContext& ctx, BestSolutionSlot& best_slot, const ConstructionSettings& settings, mt19937& gen, TelemetryShard& tel) {
+    const auto start_clock = chrono::steady_clock::now();
+    const double start_ratio = settings.start_ratio;
+    double gain = 0.0;
+    StartRecord record;
+    record.ratio = start_ratio;
+    const ProblemData& problem = ctx.problem;
+    const DistanceCache& dist = ctx.dist;
+    const NeighborLists& neighbors = ctx.neighbors;
+    const Deadline& deadline = ctx.deadline;
+    uniform_real_distribution<> dis(0.0, 1.0);
 
-                double current_dist_budget = problem.d_max;
-                double avg_food_wt = dry_ratio * problem.packages[DRY].weight + perishable_ratio * problem.packages[PER].weight;
+    double dry_ratio = start_ratio;
+    double perishable_ratio = 1.0 - start_ratio;
+    double learning_rate = 0.2;
+    int direction = 1; 
 
-                while (current_dist_budget > 1e-6) {
-                    int best_first_vil_idx = -1;
-                    double best_init_value = 0;
-                    int best_init_dry = 0, best_init_peri = 0, best_init_other = 0;
+    double previous_value = -numeric_limits<double>::max();
+    bool first_iteration = true;
+    int no_imp_count = 0;
+    const int max_no_improvement = 20; 
+    const double min_imp_threshold = 0.01;
+    
+    double temperature = 100.0;
+    double cooling_rate = 0.95;
+
+    // Unserved villages, reset at the start of every construction pass: by location in grid, and
+    // as a flat set that membership tests and resets in O(1).
+    VillageGrid grid = ctx.grid;
+    const int num_villages = static_cast<int>(problem.villages.size());
+    ActiveSet unserved(num_villages);
+    vector<int> candidates;
+    vector<int> visit_stamp(num_villages, 0);
+    int trip_stamp = 0;
+    vector<int> population(num_villages);
+    vector<int> initial_food_demand(num_villages), initial_other_demand(num_villages);
+    vector<int> no_demand;
+    for (int i = 0; i < num_villages; ++i) {
+        population[i] = problem.villages[i].population;
+        initial_food_demand[i] = 9 * population[i];
+        initial_other_demand[i] = population[i];
+        if (initial_food_demand[i] <= 0 && initial_other_demand[i] <= 0) no_demand.push_back(i);
+    }
+    vector<int> rem_food_demand, rem_other_demand;
+    // The home city's distances, filled per helicopter when the cache has no city table.
+    vector<double> home_row;
+    DeadlinePoller poll(deadline);
+    SolutionEvaluator eval(problem, dist);
+    // Rebuilt every pass into the same buffers; a new best is swapped into best_slot, which hands
+    // back the previous best's buffers.
+    FlatSolution current_solution;
+    Trip current_trip;
+    unique_ptr<PayloadOptimizer> payload;
+    if (!settings.ratio_walk) payload = make_unique<PayloadOptimizer>(problem.packages);
+
+    while (true) {
+        if (deadline.expired()) {
+            break;
+        }
 
-                    for (size_t i = 0; i < problem.villages.size(); ++i) {
-                        auto now_v = chrono::steady_clock::now();
-                        if (chrono::duration_cast<chrono::milliseconds>(deadline - now_v).count() <= 0) break;
-                        if (rem_food_demand[i] <= 0 && rem_other_demand[i] <= 0) continue;
+        current_solution.clear();
+        eval.reset();
 
-                        const Point& village_coord = problem.villages[i].coords;
-                        double trip_distance = 2.0 * distance(home, village_coord);
-                        if (trip_distance > helicopter.distance_capacity || trip_distance > current_dist_budget) continue;
+        rem_food_demand = initial_food_demand;
+        rem_other_demand = initial_other_demand;
+        grid.reset();
+        unserved.reset();
+        for (int i : no_demand) {
+            grid.remove(i);
+            unserved.remove(i);
+        }
 
-                        if (avg_food_wt < 1e-9) continue;
-                        
-                        int food_to_send = min(rem_food_demand[i], static_cast<int>(helicopter.weight_capacity / avg_food_wt));
-                        int dry_units = static_cast<int>(food_to_send * dry_ratio);
-                        int perishable_units = food_to_send - dry_units;
-
-                        double food_weight = dry_units * problem.packages[DRY].weight + perishable_units * problem.packages[PER].weight;
-                        if (food_weight > helicopter.weight_capacity + 1e-9) continue;
-
-                        double rem_weight = helicopter.weight_capacity - food_weight;
-                        int other_units = 0;
-                        if (problem.packages[OTH].weight > 1e-9 && rem_weight > 1e-9) {
-                            other_units = min(rem_other_demand[i], static_cast<int>(rem_weight / problem.packages[OTH].weight));
-                            other_units = max(0, other_units);
-                        }
-                        
-                        double total_weight = food_weight + other_units * problem.packages[OTH].weight;
-                        if (total_weight > helicopter.weight_capacity + 1e-9) continue;
-
-                        double value = calculateVillageValue(problem.villages[i], dry_units, perishable_units, other_units, problem.packages);
-                        double cost = helicopter.fixed_cost + helicopter.alpha * trip_distance;
-                        double net_value = value - cost;
-
-                        if (net_value > best_init_value) {
-                            best_init_value = net_value;
-                            best_first_vil_idx = i;
-                            best_init_dry = dry_units;
-                            best_init_peri = perishable_units;
-                            best_init_other = other_units;
-                        }
+        for (size_t k = 0; k < problem.helicopters.size(); ++k) {
+            if (deadline.expired()) break;
+            const auto& helicopter = problem.helicopters[settings.helicopter_order ? (*settings.helicopter_order)[k] : k];
+            
+            current_solution.addPlan(helicopter.id);
+            const int home_idx = helicopter.home_city_id - 1;
+            const Point& home = problem.cities[home_idx];
+
+            double current_dist_budget = problem.d_max;
+            double avg_food_wt = dry_ratio * problem.packages[DRY].weight + perishable_ratio * problem.packages[PER].weight;
+
+            FirstVillageScan first_scan;
+            first_scan.city_distance = dist.cityRow(home_idx);
+            if (!first_scan.city_distance) {
+                home_row.resize(num_villages);
+                for (int i = 0; i < num_villages; ++i) home_row[i] = dist.cityToVillage(home_idx, i);
+                first_scan.city_distance = home_row.data();
+            }
+            first_scan.population = population.data();
+            first_scan.rem_food = rem_food_demand.data();
+            first_scan.rem_other = rem_other_demand.data();
+            first_scan.packages = problem.packages.data();
+            first_scan.weight_capacity = helicopter.weight_capacity;
+            first_scan.distance_capacity = helicopter.distance_capacity;
+            first_scan.fixed_cost = helicopter.fixed_cost;
+            first_scan.alpha = helicopter.alpha;
+            first_scan.dry_ratio = dry_ratio;
+            first_scan.avg_food_weight = avg_food_wt;
+            first_scan.payload = payload.get();
+
+            while (current_dist_budget > 1e-6) {
+                int best_first_vil_idx = -1;
+                int best_init_dry = 0, best_init_peri = 0, best_init_other = 0;
+
+                // A first village must satisfy 2 * d(home, i) <= min(capacity, budget). The city's
+                // nearest villages are tried first, everything in range only if none of them pays.
+                {
+                    PhaseTimer first_scan_timer(tel, Phase::FIRST_VILLAGE_SCAN);
+                    first_scan.distance_budget = current_dist_budget;
+                    FirstVillageChoice choice;
+                    const int near_count = neighbors.cityListSize();
+                    if (near_count > 0) {
+                        choice = scanFirstVillage(first_scan, neighbors.cityBegin(home_idx), near_count);
+                        record.candidate_evaluations += near_count;
+                    }
+                    if (choice.village == -1) {
+                        candidates.clear();
+                        grid.forEachWithin(home, min(helicopter.distance_capacity, current_dist_budget) / 2.0, [&](int i) { candidates.push_back(i); });
+                        record.candidate_evaluations += candidates.size();
+                        if (!poll.expired()) choice = scanFirstVillage(first_scan, candidates.data(), candidates.size());
                     }
 
-                    if (best_first_vil_idx == -1) break;
+                    {
+                        best_first_vil_idx = choice.village;
+                        best_init_dry = choice.dry;
+                        best_init_peri = choice.perishable;
+                        best_init_other = choice.other;
+                    }
+                }
 
-                     Trip current_trip;
-                     vector<bool> visited_in_this_trip(problem.villages.size(), false);
-                    
-                    Drop first_drop = {problem.villages[best_first_vil_idx].id, best_init_dry, best_init_peri, best_init_other};
-                    current_trip.drops.push_back(first_drop);
-                    visited_in_this_trip[best_first_vil_idx] = true;
+                if (best_first_vil_idx == -1) break;
 
-                    double current_trip_weight = best_init_dry * problem.packages[DRY].weight + best_init_peri * problem.packages[PER].weight + best_init_other * problem.packages[OTH].weight;
-                    Point last_location = problem.villages[best_first_vil_idx].coords;
-                    
+                current_trip.drops.clear();
+                ++trip_stamp;
+                
+                Drop first_drop = {problem.villages[best_first_vil_idx].id, best_init_dry, best_init_peri, best_init_other};
+                current_trip.drops.push_back(first_drop);
+                visit_stamp[best_first_vil_idx] = trip_stamp;
+
+                double current_trip_weight = best_init_dry * problem.packages[DRY].weight + best_init_peri * problem.packages[PER].weight + best_init_other * problem.packages[OTH].weight;
+                int last_idx = best_first_vil_idx;
+                // Running length of the open tour home -> ... -> last_idx, accumulated leg by leg in visiting order.
+                double open_trip_dist = dist.cityToVillage(home_idx, best_first_vil_idx);
+                
+                {
+                    PhaseTimer insertion_timer(tel, Phase::INSERTION_SCAN);
                     while (true) {
                          int best_next_village_idx = -1;
                          double best_val_added_net = 0;
                          Drop best_next_drop;
                          double best_wt_added = 0;
+                         const double last_to_home = dist.cityToVillage(home_idx, last_idx);
 
-                        for (size_t j = 0; j < problem.villages.size(); ++j) {
-                            auto now_v2 = chrono::steady_clock::now();
-                            if (chrono::duration_cast<chrono::milliseconds>(deadline - now_v2).count() <= 0) break;
-                            if (visited_in_this_trip[j] || (rem_food_demand[j] <= 0 && rem_other_demand[j] <= 0)) continue;
-
-                            const Point& next_village_coord = problem.villages[j].coords;
-                            double distance_added = distance(last_location, next_village_coord) + distance(next_village_coord, home) - distance(last_location, home);
-                            
-                             double total_trip_dist_if_added = 0;
-                             Point temp_loc = home;
-                             for(const auto& drop : current_trip.drops) {
-                                 total_trip_dist_if_added += distance(temp_loc, problem.villages[drop.village_id-1].coords);
-                                 temp_loc = problem.villages[drop.village_id-1].coords;
-                             }
-                             total_trip_dist_if_added += distance(temp_loc, next_village_coord) + distance(next_village_coord, home);
+                        auto consider = [&](int j) {
+                            if (!unserved.contains(j) || visit_stamp[j] == trip_stamp) return;
+
+                            // O(1) delta: replacing the return leg last->home with last->j->home.
+                            double detour = dist.villageToVillage(last_idx, j) + dist.cityToVillage(home_idx, j);
+                            double distance_added = detour - last_to_home;
+                            double total_trip_dist_if_added = open_trip_dist + detour;
 
-                            if (total_trip_dist_if_added > helicopter.distance_capacity || total_trip_dist_if_added > current_dist_budget) continue;
+                            if (total_trip_dist_if_added > helicopter.distance_capacity || total_trip_dist_if_added > current_dist_budget) return;
 
                             double remaining_weight_cap = helicopter.weight_capacity - current_trip_weight;
-                            if (remaining_weight_cap <= 1e-9) continue;
-                            
-                            int food_to_send = min(rem_food_demand[j], static_cast<int>(remaining_weight_cap / (avg_food_wt + 1e-9)));
-                            int dry_units = static_cast<int>(food_to_send * dry_ratio);
-                            int perishable_units = food_to_send - dry_units;
-
-                            double food_weight = dry_units * problem.packages[DRY].weight + perishable_units * problem.packages[PER].weight;
-                            if (food_weight > remaining_weight_cap + 1e-9) continue;
-
-                            double temp_rem_weight = remaining_weight_cap - food_weight;
-                            int other_units = 0;
-                            if (problem.packages[OTH].weight > 1e-9 && temp_rem_weight > 1e-9) {
-                                other_units = min(rem_other_demand[j], static_cast<int>(temp_rem_weight / problem.packages[OTH].weight));
-                                other_units = max(0, other_units);
+                            if (remaining_weight_cap <= 1e-9) return;
+                        
+                            int dry_units, perishable_units, other_units;
+                            double food_weight;
+                            if (payload) {
+                                Payload load = payload->best(remaining_weight_cap, rem_food_demand[j], rem_other_demand[j]);
+                                dry_units = load.dry;
+                                perishable_units = load.perishable;
+                                other_units = load.other;
+                                food_weight = dry_units * problem.packages[DRY].weight + perishable_units * problem.packages[PER].weight;
+                            } else {
+                                int food_to_send = min(rem_food_demand[j], static_cast<int>(remaining_weight_cap / (avg_food_wt + 1e-9)));
+                                dry_units = static_cast<int>(food_to_send * dry_ratio);
+                                perishable_units = food_to_send - dry_units;
+
+                                food_weight = dry_units * problem.packages[DRY].weight + perishable_units * problem.packages[PER].weight;
+                                if (food_weight > remaining_weight_cap + 1e-9) return;
+
+                                double temp_rem_weight = remaining_weight_cap - food_weight;
+                                other_units = 0;
+                                if (problem.packages[OTH].weight > 1e-9 && temp_rem_weight > 1e-9) {
+                                    other_units = min(rem_other_demand[j], static_cast<int>(temp_rem_weight / problem.packages[OTH].weight));
+                                    other_units = max(0, other_units);
+                                }
                             }
-                            
+                        
                             double total_weight = food_weight + other_units * problem.packages[OTH].weight;
-                            if (total_weight > remaining_weight_cap + 1e-9) continue;
-                            
-                            if (dry_units + perishable_units + other_units == 0) continue;
+                            if (total_weight > remaining_weight_cap + 1e-9) return;
+                        
+                            if (dry_units + perishable_units + other_units == 0) return;
 
                             double value_added = calculateVillageValue(problem.villages[j], dry_units, perishable_units, other_units, problem.packages);
                             double cost_added = helicopter.alpha * distance_added;
-                            
-                             if (value_added - cost_added > best_val_added_net) {
+                        
+                             if (value_added - cost_added > best_val_added_net || (value_added - cost_added == best_val_added_net && best_next_village_idx != -1 && j < best_next_village_idx)) {
                                  best_val_added_net = value_added - cost_added;
                                  best_next_village_idx = j;
                                  best_next_drop = {problem.villages[j].id, dry_units, perishable_units, other_units};
                                  best_wt_added = total_weight; 
                              }
+                        };
+
+                        // The nearest villages of last first: the best extension is almost always among them.
+                        const int* near_begin = neighbors.villageBegin(last_idx);
+                        const int* near_end = neighbors.villageEnd(last_idx);
+                        for (const int* it = near_begin; it != near_end && !poll.expired(); ++it) consider(*it);
+                        record.candidate_evaluations += near_end - near_begin;
+
+                        // None of them fits: scan everything in range.
+                        // Any feasible j has d(last, j) <= d(last, j) + d(j, home) <= min(capacity, budget) - open length.
+                        if (best_next_village_idx == -1) {
+                            candidates.clear();
+                            grid.forEachWithin(problem.villages[last_idx].coords, min(helicopter.distance_capacity, current_dist_budget) - open_trip_dist, [&](int j) { candidates.push_back(j); });
+                            record.candidate_evaluations += candidates.size();
+                            for (int j : candidates) {
+                                if (poll.expired()) break;
+                                consider(j);
+                            }
                         }
 
                         if (best_next_village_idx != -1) {
                             current_trip.drops.push_back(best_next_drop);
-                            visited_in_this_trip[best_next_village_idx] = true;
+                            visit_stamp[best_next_village_idx] = trip_stamp;
                             current_trip_weight += best_wt_added;
-                            last_location = problem.villages[best_next_village_idx].coords;
+                            open_trip_dist += dist.villageToVillage(last_idx, best_next_village_idx);
+                            last_idx = best_next_village_idx;
                         } else {
                             break;
                         }
                     }
+                }
 
-                     current_trip.dry_food_pickup = 0;
-                     current_trip.perishable_food_pickup = 0;
-                     current_trip.other_supplies_pickup = 0;
+                 current_trip.dry_food_pickup = 0;
+                 current_trip.perishable_food_pickup = 0;
+                 current_trip.other_supplies_pickup = 0;
+                 
+                 for (const auto& drop : current_trip.drops) {
+                     current_trip.dry_food_pickup += drop.dry_food;
+                     current_trip.perishable_food_pickup += drop.perishable_food;
+                     current_trip.other_supplies_pickup += drop.other_supplies;
                      
-                     for (const auto& drop : current_trip.drops) {
-                         current_trip.dry_food_pickup += drop.dry_food;
-                         current_trip.perishable_food_pickup += drop.perishable_food;
-                         current_trip.other_supplies_pickup += drop.other_supplies;
-                         
-                         int village_idx = drop.village_id - 1;
-                         rem_food_demand[village_idx] = max(0, rem_food_demand[village_idx] - (drop.dry_food + drop.perishable_food));
-                         rem_other_demand[village_idx] = max(0, rem_other_demand[village_idx] - drop.other_supplies);
+                     int village_idx = drop.village_id - 1;
+                     rem_food_demand[village_idx] = max(0, rem_food_demand[village_idx] - (drop.dry_food + drop.perishable_food));
+                     rem_other_demand[village_idx] = max(0, rem_other_demand[village_idx] - drop.other_supplies);
+                     if (rem_food_demand[village_idx] <= 0 && rem_other_demand[village_idx] <= 0) {
+                         grid.remove(village_idx);
+                         unserved.remove(village_idx);
                      }
+                 }
 
-                    double final_trip_dist = 0;
-                    Point current_loc = home;
-                    for(const auto& drop : current_trip.drops) {
-                        final_trip_dist += distance(current_loc, problem.villages[drop.village_id-1].coords);
-                        current_loc = problem.villages[drop.village_id-1].coords;
-                    }
-                    final_trip_dist += distance(current_loc, home);
-
-                    plan.trips.push_back(current_trip);
-                    current_dist_budget -= final_trip_dist;
+                double final_trip_dist = open_trip_dist + dist.cityToVillage(home_idx, last_idx);
+                if (ctx.options.improve_routes) {
+                    // Shorter tours hand the saved distance back to the helicopter's d_max budget.
+                    PhaseTimer route_timer(tel, Phase::ROUTE_IMPROVEMENT);
+                    final_trip_dist = improveTripRoute(dist, home_idx, current_trip.drops);
                 }
-                current_solution.push_back(plan);
-            }
-            
-            double tval_gained = 0;
-            double ttrip_cost = 0;
-            vector<double> food_delivered(problem.villages.size() + 1, 0.0);
-            vector<double> other_delivered(problem.villages.size() + 1, 0.0);
-
-            for (const auto& helicopter_plan : current_solution) {
-                const auto& helicopter = problem.helicopters[helicopter_plan.helicopter_id - 1];
-                Point home_city_coords = problem.cities[helicopter.home_city_id - 1];
-
-                for (const auto& trip : helicopter_plan.trips) {
-                    if (trip.drops.empty()) continue;
-
-                     double trip_distance = 0;
-                     Point current_location = home_city_coords;
-                     for (const auto& drop : trip.drops) {
-                         const auto& village_coords = problem.villages[drop.village_id - 1].coords;
-                         trip_distance += distance(current_location, village_coords);
-                         current_location = village_coords;
-                     }
-                     trip_distance += distance(current_location, home_city_coords);
-
-                    ttrip_cost += helicopter.fixed_cost + (helicopter.alpha * trip_distance);
 
-                    for (const auto& drop : trip.drops) {
-                        const auto& village = problem.villages[drop.village_id - 1];
-                        double max_food_needed = village.population * 9.0;
-                        double food_room_left = max(0.0, max_food_needed - food_delivered[village.id]);
-                        double food_in_this_drop = drop.dry_food + drop.perishable_food;
-                        double effective_food = min(food_in_this_drop, food_room_left);
-                        
-                        double effective_vp = min((double)drop.perishable_food, effective_food);
-                        tval_gained += effective_vp * problem.packages[PER].value;
-                        double effective_vd = min((double)drop.dry_food, effective_food - effective_vp);
-                        tval_gained += effective_vd * problem.packages[DRY].value;
-                        food_delivered[village.id] += food_in_this_drop;
-
-                        double max_other_needed = village.population * 1.0;
-                        double other_room_left = max(0.0, max_other_needed - other_delivered[village.id]);
-                        double effective_vo = min((double)drop.other_supplies, other_room_left);
-                        tval_gained += effective_vo * problem.packages[OTH].value;
-                        other_delivered[village.id] += drop.other_supplies;
-                    }
+                current_solution.addTrip(current_trip);
+                {
+                    PhaseTimer eval_timer(tel, Phase::EVALUATION);
+                    eval.addTrip(helicopter.id - 1, current_trip);
                 }
+                tel.add(Counter::TRIPS_BUILT, 1);
+                current_dist_budget -= final_trip_dist;
             }
-            double final_value = tval_gained - ttrip_cost;
-
-            if (final_value > best_value) {
-                double improvement = final_value - best_value;
-                best_value = final_value;
-                best_global_solution = current_solution;
-                
-                if (improvement >= min_imp_threshold) {
-                    no_imp_count = 0;
-                } else {
-                    no_imp_count++;
-                }
+        }
+        
+        double final_value;
+        {
+            PhaseTimer eval_timer(tel, Phase::EVALUATION);
+            final_value = eval.objective();
+        }
+        ctx.counters.construction_passes.fetch_add(1, memory_order_relaxed);
+        record.best_value = (record.passes == 0) ? final_value : max(record.best_value, final_value);
+        record.passes++;
+
+        double improvement = 0;
+        if (best_slot.offer(final_value, current_solution, improvement, "ratio")) {
+            gain += improvement;
+            if (improvement >= min_imp_threshold) {
+                no_imp_count = 0;
             } else {
                 no_imp_count++;
             }
-            
-            if (no_imp_count >= max_no_improvement) {
-                break;
-            }
+        } else {
+            no_imp_count++;
+        }
+        
+        // Loads no longer depend on the ratio, so another pass would build the same plan.
+        if (!settings.ratio_walk) break;
 
-            if (first_iteration) {
-                previous_value = final_value;
-                first_iteration = false;
-                dry_ratio += direction * learning_rate;
-            } else {
-                double acceptance_prob = exp((final_value - previous_value) / temperature);
-                
-                if (final_value < previous_value) {
-                    if (dis(gen) < acceptance_prob) {
-                        previous_value = final_value;
-                        dry_ratio += direction * learning_rate;
-                    } else {
-                        direction *= -1;
-                        learning_rate *= 0.9;
-                        previous_value = final_value;
-                        dry_ratio += direction * learning_rate;
-                    }
+        if (no_imp_count >= max_no_improvement || record.passes == settings.max_passes) {
+            break;
+        }
+
+        if (first_iteration) {
+            previous_value = final_value;
+            first_iteration = false;
+            dry_ratio += direction * learning_rate;
+        } else {
+            double acceptance_prob = exp((final_value - previous_value) / temperature);
+            
+            if (final_value < previous_value) {
+                if (dis(gen) < acceptance_prob) {
+                    previous_value = final_value;
+                    dry_ratio += direction * learning_rate;
                 } else {
-                    learning_rate *= 1.1;
+                    direction *= -1;
+                    learning_rate *= 0.9;
                     previous_value = final_value;
                     dry_ratio += direction * learning_rate;
                 }
+            } else {
+                learning_rate *= 1.1;
+                previous_value = final_value;
+                dry_ratio += direction * learning_rate;
             }
-            
-            dry_ratio = max(0.0, min(1.0, dry_ratio));
-            perishable_ratio = 1.0 - dry_ratio;
-            learning_rate = max(0.05, min(0.3, learning_rate));
-            temperature *= cooling_rate; 
+        }
+        
+        dry_ratio = max(0.0, min(1.0, dry_ratio));
+        perishable_ratio = 1.0 - dry_ratio;
+        learning_rate = max(0.05, min(0.3, learning_rate));
+        temperature *= cooling_rate; 
+
+    }
+
+    record.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_clock).count();
+    tel.add(Counter::CONSTRUCTION_PASSES, record.passes);
+    tel.add(Counter::CANDIDATE_EVALUATIONS, record.candidate_evaluations);
+    tel.recordStart(record);
+    return gain;
+}
 
+/**
+ * @brief Improves a snapshot of best_slot's plan with ALNS until the deadline or for max_iterations
+ * iterations (0 = no cap), publishing every new best (scored exactly like the checker) back to it.
+ */
+static void runAlns(const SearchContext& ctx, BestSolutionSlot& best_slot, unsigned seed, long max_iterations, TelemetryShard& tel) {
+    PhaseTimer alns_timer(tel, Phase::ALNS);
+    SolutionEvaluator eval(ctx.problem, ctx.dist);
+    AlnsSearch alns(ctx.problem, ctx.dist, ctx.grid, seed, &ctx.neighbors);
+    alns.setSolution(best_slot.snapshot());
+    FlatSolution candidate;
+    alns.run(ctx.deadline, max_iterations, [&](const FlatSolution& improved) {
+        eval.load(improved);
+        candidate = improved;
+        double improvement = 0;
+        best_slot.offer(eval.objective(), candidate, improvement, "alns");
+    });
+    ctx.counters.alns_iterations.fetch_add(alns.iterations(), memory_order_relaxed);
+    tel.add(Counter::ALNS_ITERATIONS, alns.iterations());
+}
+
+// Portfolio arms, in the order the scheduler tries them first: ALNS gets to improve the first
+// plan before the ratio walk is measured against it.
+enum PortfolioArm { GREEDY_ARM, ALNS_ARM, RATIO_WALK_ARM };
+static const char* const kArmNames[] = {"greedy", "alns", "ratio_walk"};
+static const long kWalkPassesPerPull = 5;    // Passes of one ratio-walk pull, unless it stalls first.
+static const double kSlicesLeft = 20.0;      // An ALNS pull runs for 1/kSlicesLeft of the time left,
+static const double kMinSliceSeconds = 0.05; // clamped to these bounds.
+static const double kMaxSliceSeconds = 1.0;
+
+/**
+ * @brief Pulls arms of the shared portfolio until the deadline passes. best_slot must already
+ * hold a plan, so that every pull is measured against one.
+ *
+ * Greedy pulls build one plan with the payload optimizer, with the helicopters in random order.
+ * Ratio-walk pulls walk from a random starting ratio for up to kWalkPassesPerPull passes. ALNS
+ * pulls continue this worker's search for a slice of the time left, after taking over the shared
+ * best plan if another arm or worker has beaten the search's own best; the search cools over the
+ * whole remaining run, not per slice.
+ */
+static void runPortfolio(const SearchContext& ctx, BestSolutionSlot& best_slot, PortfolioScheduler& portfolio, const vector<PortfolioArm>& arms,
+                         int worker, unsigned seed, Deadline::Clock::time_point start_time, TelemetryShard& tel) {
+    mt19937 gen(seed);
+    uniform_real_distribution<> dis(0.0, 1.0);
+    vector<int> order(ctx.problem.helicopters.size());
+    unique_ptr<AlnsSearch> alns;
+    SolutionEvaluator eval(ctx.problem, ctx.dist);
+    FlatSolution candidate;
+
+    while (!ctx.deadline.expired()) {
+        const int choice = portfolio.choose();
+        const PortfolioArm arm = arms[choice];
+        const auto pull_start = Deadline::Clock::now();
+        double gain = 0.0;
+
+        if (arm == ALNS_ARM) {
+            if (!alns) {
+                alns = make_unique<AlnsSearch>(ctx.problem, ctx.dist, ctx.grid, gen(), &ctx.neighbors);
+                alns->setHorizon(pull_start, ctx.deadline.end());
+                alns->setSolution(best_slot.snapshot());
+            } else if (best_slot.value() > alns->bestObjective() + 1e-9) {
+                alns->setSolution(best_slot.snapshot());
+            }
+            const double left = chrono::duration<double>(ctx.deadline.end() - pull_start).count();
+            const double slice = max(kMinSliceSeconds, min(kMaxSliceSeconds, left / kSlicesLeft));
+            const Deadline slice_deadline(pull_start + chrono::duration_cast<Deadline::Clock::duration>(chrono::duration<double>(slice)), ctx.deadline);
+
+            PhaseTimer alns_timer(tel, Phase::ALNS);
+            const long iterations_before = alns->iterations();
+            alns->run(slice_deadline, 0, [&](const FlatSolution& improved) {
+                eval.load(improved);
+                candidate = improved;
+                double improvement = 0;
+                if (best_slot.offer(eval.objective(), candidate, improvement, "alns")) gain += improvement;
+            });
+            ctx.counters.alns_iterations.fetch_add(alns->iterations() - iterations_before, memory_order_relaxed);
+            tel.add(Counter::ALNS_ITERATIONS, alns->iterations() - iterations_before);
+        } else {
+            ConstructionSettings settings;
+            if (arm == RATIO_WALK_ARM) {
+                settings.ratio_walk = true;
+                settings.start_ratio = dis(gen);
+                settings.max_passes = kWalkPassesPerPull;
+            } else {
+                iota(order.begin(), order.end(), 0);
+                shuffle(order.begin(), order.end(), gen);
+                settings.helicopter_order = &order;
+            }
+            gain = runConstruction(ctx, best_slot, settings, gen, tel);
         }
+
+        AllocationRecord record;
+        record.at_seconds = chrono::duration<double>(pull_start - start_time).count();
+        record.worker = worker;
+        record.arm = portfolio.name(choice);
+        record.seconds = chrono::duration<double>(Deadline::Clock::now() - pull_start).count();
+        record.gain = gain;
+        record.rate = portfolio.report(choice, gain, record.seconds);
+        tel.recordAllocation(record);
     }
+}
 
-    
+/**
+ * @brief Keeps only the trips that pass the grader's checks and still fit in each helicopter's
+ * DMax, in plan order; trips with negative loads and empty trips are dropped as well.
+ */
+static Solution validatePlan(const ProblemData& problem, const SolutionScorer& scorer, const Solution& plan_to_check) {
+    vector<Violation> violations;
     Solution validated_solution;
-    for (const auto& plan : best_global_solution) {
+    for (const auto& plan : plan_to_check) {
         HelicopterPlan validated_plan;
         validated_plan.helicopter_id = plan.helicopter_id;
-        
-        const auto& helicopter = problem.helicopters[plan.helicopter_id - 1];
-        const Point& home = problem.cities[helicopter.home_city_id - 1];
+        const int heli_idx = plan.helicopter_id - 1;
         double total_distance_used = 0.0;
         
         for (const auto& trip : plan.trips) {
             if (trip.drops.empty()) continue;
             
-            int total_dry_dropped = 0, total_peri_dropped = 0, total_other_dropped = 0;
-            for (const auto& drop : trip.drops) {
-                total_dry_dropped += drop.dry_food;
-                total_peri_dropped += drop.perishable_food;
-                total_other_dropped += drop.other_supplies;
-            }
-            
-            if (trip.dry_food_pickup != total_dry_dropped || trip.perishable_food_pickup != total_peri_dropped || trip.other_supplies_pickup != total_other_dropped || trip.dry_food_pickup < 0 || trip.perishable_food_pickup < 0 || trip.other_supplies_pickup < 0) {
-                continue; 
-            }
-            
-            bool has_negative_drops = false;
+            bool has_negative_loads = trip.dry_food_pickup < 0 || trip.perishable_food_pickup < 0 || trip.other_supplies_pickup < 0;
             for (const auto& drop : trip.drops) {
-                if (drop.dry_food < 0 || drop.perishable_food < 0 || drop.other_supplies < 0) {
-                    has_negative_drops = true;
-                    break;
-                }
-            }
-            if (has_negative_drops) continue;
-            
-            double trip_distance = 0.0;
-            Point current_location = home;
-            for (const auto& drop : trip.drops) {
-                const Point& village_coords = problem.villages[drop.village_id - 1].coords;
-                trip_distance += distance(current_location, village_coords);
-                current_location = village_coords;
+                has_negative_loads = has_negative_loads || drop.dry_food < 0 || drop.perishable_food < 0 || drop.other_supplies < 0;
             }
-            trip_distance += distance(current_location, home);
+            if (has_negative_loads) continue;
             
-            if (trip_distance > helicopter.distance_capacity + 1e-9) continue;
+            violations.clear();
+            double trip_distance = scorer.checkTrip(heli_idx, static_cast<int>(validated_plan.trips.size()), trip, violations);
+            if (!violations.empty()) continue;
             
             if (total_distance_used + trip_distance > problem.d_max + 1e-9) continue;
             
-            double trip_weight = trip.dry_food_pickup * problem.packages[DRY].weight + trip.perishable_food_pickup * problem.packages[PER].weight + trip.other_supplies_pickup * problem.packages[OTH].weight;
-            if (trip_weight > helicopter.weight_capacity + 1e-9) continue;
-            
             validated_plan.trips.push_back(trip);
             total_distance_used += trip_distance;
         }
@@ -401,6 +635,368 @@ Solution solve(const ProblemData& problem) {
             validated_solution.push_back(validated_plan);
         }
     }
+    return validated_solution;
+}
+
+// Share of the time left, and of the iteration budget, that a decomposed solve spends on the regions;
+// the rest goes to the repair pass over the merged plan.
+static const double kRegionShare = 0.7;
+
+/**
+ * @brief Solves every region of parts as an instance of its own and merges the results.
+ *
+ * Regions are claimed largest first by up to options.num_threads threads, each solved on one
+ * thread. A region gets kRegionShare of the time left in proportion to its village count, scaled
+ * by the number of regions running side by side and cut off at the end of the regional phase; in
+ * reproducible mode it also gets that share of the iteration budget and a seed of its own, so its
+ * plan does not depend on the thread count. Regions not started by the end of the phase stay empty.
+ * cut_short is set if the clock decided any region's plan: one not started in time, or one whose
+ * own solve its time limit ended -- the merged plan then depends on timing after all.
+ */
+static Solution solveRegions(const ProblemData& problem, const SolverOptions& options, const Decomposition& parts, const Deadline& deadline, unsigned base_seed,
+                             WorkCounters& counters, bool& cut_short) {
+    const size_t num_regions = parts.regions.size();
+    size_t assigned = 0;
+    for (const auto& region : parts.regions) assigned += region.villages.size();
+
+    vector<size_t> order(num_regions);
+    iota(order.begin(), order.end(), size_t(0));
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return parts.regions[a].villages.size() > parts.regions[b].villages.size(); });
+
+    const auto phase_start = Deadline::Clock::now();
+    const double phase_seconds = kRegionShare * max(0.0, chrono::duration<double>(deadline.end() - phase_start).count());
+    const auto phase_end = phase_start + chrono::duration_cast<Deadline::Clock::duration>(chrono::duration<double>(phase_seconds));
+    int num_threads = options.num_threads > 0 ? options.num_threads : max(1u, thread::hardware_concurrency());
+    num_threads = max(1, min(num_threads, static_cast<int>(num_regions)));
+
+    vector<Solution> solutions(num_regions);
+    atomic<size_t> next_region(0);
+    atomic<bool> timed_out(false);
+    auto worker = [&]() {
+        while (true) {
+            size_t k = next_region.fetch_add(1);
+            if (k >= num_regions) break;
+            if (deadline.expired()) {
+                timed_out.store(true, memory_order_relaxed);
+                break;
+            }
+            const size_t r = order[k];
+            const Region& region = parts.regions[r];
+            if (region.villages.empty() || region.helicopters.empty()) continue;
+
+            const double share = static_cast<double>(region.villages.size()) / assigned;
+            const double seconds = min(phase_seconds * min(1.0, num_threads * share), chrono::duration<double>(phase_end - Deadline::Clock::now()).count());
+            if (seconds <= 0.0) {
+                timed_out.store(true, memory_order_relaxed);
+                continue;
+            }
+
+            SolverStats stats;
+            SolverOptions sub_options;
+            sub_options.num_threads = 1;
+            sub_options.cancel = options.cancel;
+            sub_options.improve_routes = options.improve_routes;
+            sub_options.use_alns = options.use_alns;
+            sub_options.ratio_walk = options.ratio_walk;
+            sub_options.stats = &stats;
+            sub_options.seed = deriveSeed(base_seed, kRegionStreamBase + static_cast<unsigned>(r));
+            if (options.iteration_budget > 0) sub_options.iteration_budget = max(1L, static_cast<long>(options.iteration_budget * kRegionShare * share));
+            sub_options.decompose_min_villages = 0;
+            sub_options.time_limit_seconds = seconds;
+            solutions[r] = solve(regionProblem(problem, region), sub_options);
+
+            counters.construction_passes.fetch_add(stats.construction_passes, memory_order_relaxed);
+            counters.alns_iterations.fetch_add(stats.alns_iterations, memory_order_relaxed);
+            if (stats.deadline_reached) timed_out.store(true, memory_order_relaxed);
+        }
+    };
+
+    if (num_threads == 1) {
+        worker();
+    } else {
+        vector<thread> workers;
+        for (int t = 0; t < num_threads; ++t) workers.emplace_back(worker);
+        for (auto& w : workers) w.join();
+    }
+    cut_short = timed_out.load();
+    return mergeRegionSolutions(problem, parts, solutions);
+}
+
+Solution solve(const ProblemData& problem, const SolverOptions& options) {
+
+    auto start_time = chrono::steady_clock::now();
+    // With checkpoints on disk a late finish no longer loses the plan, so the whole budget is used.
+    const bool checkpointing = !options.checkpoint_path.empty();
+    Deadline deadline = options.time_limit_seconds > 0
+        ? Deadline(start_time + chrono::duration_cast<Deadline::Clock::duration>(chrono::duration<double>(options.time_limit_seconds)), options.cancel)
+        : Deadline::fromTimeLimit(problem.time_limit_minutes, checkpointing ? 100 : 95, start_time, options.cancel);
+    Telemetry* telemetry = options.telemetry;
+    if (telemetry) telemetry->start();
+
+    // Built once and shared read-only by every worker and by the final validation pass.
+    DistanceCache local_dist;
+    DistanceCache& dist = options.workspace ? options.workspace->dist : local_dist;
+    dist.rebuild(problem);
+    const VillageGrid grid(problem.villages);
+    
+    const bool reproducible = options.iteration_budget > 0;
+    const unsigned base_seed = options.seed >= 0 ? static_cast<unsigned>(options.seed) : random_device()();
+
+    // Country-sized instances are first solved one home city's region at a time; the merged plan
+    // then replaces construction as the start of the search, which only repairs it with ALNS.
+    // A warm start replaces construction the same way.
+    const bool warm = options.warm_start != nullptr;
+    Decomposition parts;
+    if (!warm && options.decompose_min_villages > 0 && problem.villages.size() >= static_cast<size_t>(options.decompose_min_villages)) {
+        parts = decomposeByHomeCity(problem, dist);
+    }
+    const bool decompose = parts.regions.size() > 1;
+    const bool seeded = warm || decompose;
+
+    int num_threads = options.num_threads > 0 ? options.num_threads : max(1u, thread::hardware_concurrency());
+    // Timed runs that construct from scratch share their time between strategies by how fast each
+    // is raising the best plan (see portfolio.h) instead of walking a fixed list of starts.
+    // Reproducible runs keep their fixed pipelines, since the scheduler's choices depend on timing,
+    // and --ratio-walk keeps the classic schedule it exists to reproduce.
+    const bool scheduled = !reproducible && !seeded && !options.ratio_walk;
+    vector<double> starting_ratios = buildStartingRatios(reproducible ? 1 : num_threads);
+    if (seeded || scheduled) starting_ratios.clear();
+    num_threads = max(1, min(num_threads, (seeded || scheduled) ? num_threads : static_cast<int>(starting_ratios.size())));
+
+    // A decomposed solve's regions build their own lists; its repair pass falls back on the grid.
+    NeighborLists neighbors;
+    if (!decompose) {
+        const auto lists_start = chrono::steady_clock::now();
+        neighbors.build(problem, grid, options.candidate_neighbors, num_threads);
+        if (telemetry) telemetry->note("neighbor_lists_seconds", chrono::duration<double>(chrono::steady_clock::now() - lists_start).count());
+    }
+
+    // Every new best goes to the checkpoint file through the writer thread, validated like the final plan.
+    unique_ptr<SolutionScorer> checkpoint_scorer;
+    unique_ptr<CheckpointWriter> checkpoint;
+    if (checkpointing) {
+        checkpoint_scorer = make_unique<SolutionScorer>(problem, dist);
+        checkpoint = make_unique<CheckpointWriter>(options.checkpoint_path, [&problem, scorer = checkpoint_scorer.get()](const Solution& plan) {
+            return validatePlan(problem, *scorer, plan);
+        });
+    }
+
+    BestSolutionSlot best_slot(telemetry, checkpoint.get());
+    WorkCounters counters;
+    const SearchContext ctx = {problem, options, dist, grid, neighbors, deadline, counters};
+    atomic<size_t> next_start(0);
+    bool regions_cut_short = false;
+
+    // The upper bound is tightened on its own thread, aimed at the best plan so far, and then
+    // watches the gap; a timed run within options.gap_tolerance of the bound ends right there.
+    // Even the first bound is evaluated there, off the search's time. The thread has a deadline of
+    // its own, cancelled as soon as the search ends, so solve() never waits on a half-finished
+    // evaluation; a bound not ready by then is reported as unavailable.
+    UpperBound bound(problem, dist);
+    const bool stop_at_gap = !reproducible && options.gap_tolerance >= 0;
+    CancellationToken search_done;
+    const Deadline bound_deadline(deadline.end(), &search_done);
+    bool stopped_at_gap = false;
+    thread bound_thread([&]() {
+        bool tightening = true;
+        while (!bound_deadline.expired()) {
+            if (tightening) {
+                tightening = bound.tighten(best_slot.value(), bound_deadline);
+            } else {
+                this_thread::sleep_for(chrono::milliseconds(5));
+            }
+            if (stop_at_gap && optimalityGap(bound.value(), best_slot.value()) <= options.gap_tolerance) {
+                stopped_at_gap = true;
+                deadline.cancel();
+                break;
+            }
+        }
+    });
+
+    if (warm) {
+        WarmStartReport repairs;
+        FlatSolution start(repairWarmStart(problem, dist, *options.warm_start, repairs));
+        SolutionEvaluator eval(problem, dist);
+        eval.load(start);
+        double improvement = 0;
+        best_slot.offer(eval.objective(), start, improvement, "warm_start");
+        if (telemetry) {
+            telemetry->note("warm_trips_kept", repairs.trips_kept);
+            telemetry->note("warm_trips_repaired", repairs.trips_repaired);
+            telemetry->note("warm_trips_dropped", repairs.trips_dropped);
+        }
+    } else if (decompose) {
+        TelemetryShard tel(telemetry != nullptr);
+        const auto regions_start = chrono::steady_clock::now();
+        FlatSolution merged(solveRegions(problem, options, parts, deadline, base_seed, counters, regions_cut_short));
+        SolutionEvaluator eval(problem, dist);
+        eval.load(merged);
+        double improvement = 0;
+        best_slot.offer(eval.objective(), merged, improvement, "regions");
+        tel.addTime(Phase::REGIONS, chrono::steady_clock::now() - regions_start);
+        if (telemetry) {
+            telemetry->merge(tel);
+            telemetry->note("regions", parts.regions.size());
+            telemetry->note("boundary_villages", parts.boundary.size());
+            telemetry->note("unreachable_villages", parts.unreachable);
+        }
+    }
+
+    // Reproducible mode: every start is an independent pipeline with its own generator and its own
+    // best slot -- construction followed by its share of the ALNS iteration budget -- so nothing
+    // depends on which thread runs it or when. The pipelines' bests are merged in start order.
+    const size_t num_starts = starting_ratios.size();
+    vector<BestSolutionSlot> start_slots(reproducible ? num_starts : 0);
+    auto runPipeline = [&](size_t idx, TelemetryShard& tel) {
+        mt19937 gen(deriveSeed(base_seed, kStartStreamBase + static_cast<unsigned>(idx)));
+        ConstructionSettings settings;
+        settings.start_ratio = starting_ratios[idx];
+        settings.ratio_walk = options.ratio_walk;
+        runConstruction(ctx, start_slots[idx], settings, gen, tel);
+        long share = options.iteration_budget / num_starts + (idx < options.iteration_budget % num_starts ? 1 : 0);
+        if (options.use_alns && share > 0 && !deadline.expired()) {
+            runAlns(ctx, start_slots[idx], gen(), share, tel);
+        }
+    };
+
+    vector<PortfolioArm> arms;
+    vector<const char*> arm_names;
+    for (PortfolioArm arm : {GREEDY_ARM, ALNS_ARM, RATIO_WALK_ARM}) {
+        if (arm == ALNS_ARM && !options.use_alns) continue;
+        arms.push_back(arm);
+        arm_names.push_back(kArmNames[arm]);
+    }
+    PortfolioScheduler portfolio(arm_names);
+    if (scheduled) {
+        // The plan every pull is measured against: one greedy pass in roster order.
+        TelemetryShard tel(telemetry != nullptr);
+        mt19937 gen(deriveSeed(base_seed, kStartStreamBase));
+        runConstruction(ctx, best_slot, ConstructionSettings(), gen, tel);
+        if (telemetry) telemetry->merge(tel);
+    }
+
+    // Scheduled workers pull arms of the portfolio until the deadline passes. Otherwise each worker claims
+    // the next unclaimed start ratio until all starts are taken or the deadline passes.
+    // With one worker this walks the starts in order with a single generator, exactly like the serial search.
+    // Workers that run out of starts spend the rest of the budget improving the best plan with ALNS.
+    auto worker = [&](int index, unsigned seed) {
+        mt19937 gen(seed);
+        TelemetryShard tel(telemetry != nullptr);
+        if (scheduled) {
+            runPortfolio(ctx, best_slot, portfolio, arms, index, seed, start_time, tel);
+            if (telemetry) telemetry->merge(tel);
+            return;
+        }
+        while (true) {
+            size_t idx = next_start.fetch_add(1);
+            if (idx >= num_starts) break;
+            if (deadline.expired()) break;
+            if (reproducible) {
+                runPipeline(idx, tel);
+            } else {
+                ConstructionSettings settings;
+                settings.start_ratio = starting_ratios[idx];
+                settings.ratio_walk = options.ratio_walk;
+                runConstruction(ctx, best_slot, settings, gen, tel);
+            }
+        }
+        if (!reproducible && options.use_alns && !deadline.expired()) {
+            runAlns(ctx, best_slot, gen(), 0, tel);
+        }
+        if (telemetry) telemetry->merge(tel);
+    };
+
+    if (num_threads == 1) {
+        worker(0, deriveSeed(base_seed, 0));
+    } else {
+        vector<thread> workers;
+        workers.reserve(num_threads);
+        for (int t = 0; t < num_threads; ++t) {
+            workers.emplace_back(worker, t, deriveSeed(base_seed, t));
+        }
+        for (auto& w : workers) w.join();
+    }
+
+    // Strictly better values win, so on ties the earlier start is kept.
+    for (auto& slot : start_slots) {
+        double improvement = 0;
+        FlatSolution pipeline_best = slot.take();
+        best_slot.offer(slot.value(), pipeline_best, improvement, "pipeline");
+    }
+
+    // Reproducible search from a warm start or a decomposed solve's merged plan: one ALNS run with
+    // what the regions left of the budget (the timed mode's workers above already ran theirs).
+    const long repair_budget = decompose ? options.iteration_budget - static_cast<long>(options.iteration_budget * kRegionShare) : options.iteration_budget;
+    if (seeded && reproducible && options.use_alns && repair_budget > 0 && !deadline.expired()) {
+        TelemetryShard tel(telemetry != nullptr);
+        runAlns(ctx, best_slot, deriveSeed(base_seed, kRepairStream), repair_budget, tel);
+        if (telemetry) telemetry->merge(tel);
+    }
+    search_done.cancel();
+    bound_thread.join();
+    const bool deadline_reached = (deadline.expired() && !stopped_at_gap) || regions_cut_short;
+
+    Solution best_global_solution = best_slot.take().toSolution();
+    auto search_end = chrono::steady_clock::now();
+    
+    // Final self-check with the grader's own rules.
+    SolutionScorer scorer(problem, dist);
+    Solution validated_solution = validatePlan(problem, scorer, best_global_solution);
+    if (checkpoint) {
+        FlatSolution final_plan(validated_solution);
+        checkpoint->publish(final_plan);
+        checkpoint->finish();
+        // The final plan exists only in the checkpoint file; without it the run has no output.
+        if (!checkpoint->lastWriteOk()) {
+            throw runtime_error(checkpoint->lastError());
+        }
+    }
+
+    ScoreReport report = scorer.score(validated_solution);
+    for (const auto& violation : report.violations) {
+        cerr << "Warning: validated solution still breaks a constraint: " << describeViolation(violation) << endl;
+    }
+
+    if (telemetry) {
+        TelemetryShard tel(true);
+        tel.addTime(Phase::VALIDATION, chrono::steady_clock::now() - search_end);
+        telemetry->merge(tel);
+        telemetry->note("seed", base_seed);
+        telemetry->note("threads", num_threads);
+        telemetry->note("iteration_budget", options.iteration_budget);
+        telemetry->note("time_limit_seconds", problem.time_limit_minutes * 60.0);
+        telemetry->note("search_seconds", chrono::duration<double>(search_end - start_time).count());
+        telemetry->note("deadline_reached", deadline_reached);
+        telemetry->note("best_objective", report.objective);
+        // JSON has no infinity: without a bound (not ready in time, or none exists) there are no bound or gap entries.
+        if (isfinite(bound.value())) {
+            telemetry->note("upper_bound", bound.value());
+            telemetry->note("optimality_gap", optimalityGap(bound.value(), report.objective));
+        }
+        telemetry->note("bound_steps", bound.steps());
+        telemetry->note("stopped_at_gap", stopped_at_gap);
+        if (scheduled) {
+            for (int a = 0; a < portfolio.numArms(); ++a) {
+                const string prefix = string("portfolio_") + portfolio.name(a);
+                telemetry->note(prefix + "_pulls", portfolio.pulls(a));
+                telemetry->note(prefix + "_seconds", portfolio.seconds(a));
+                telemetry->note(prefix + "_gain", portfolio.gain(a));
+            }
+        }
+        if (checkpoint) telemetry->note("checkpoint_writes", checkpoint->writes());
+    }
+
+    if (options.stats) {
+        options.stats->construction_passes = counters.construction_passes.load();
+        options.stats->alns_iterations = counters.alns_iterations.load();
+        options.stats->search_seconds = chrono::duration<double>(search_end - start_time).count();
+        options.stats->best_objective = report.objective;
+        options.stats->seed = base_seed;
+        options.stats->deadline_reached = deadline_reached;
+        options.stats->upper_bound = bound.value();
+        options.stats->optimality_gap = optimalityGap(bound.value(), report.objective);
+        options.stats->stopped_at_gap = stopped_at_gap;
+    }
 
     return validated_solution;
 }
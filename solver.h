@@ -3,12 +3,87 @@
 
 #include "structures.h"
 #include <chrono>
+#include <string>
+#include "deadline.h"
+#include "telemetry.h"
+#include "distance_cache.h"
+
+/**
+ * @brief Work counters filled in by solve() when SolverOptions::stats is set.
+ */
+struct SolverStats {
+    long construction_passes = 0; // Complete plans built by greedy construction, over all starts.
+    long alns_iterations = 0;     // Destroy/repair iterations, over all ALNS workers.
+    double search_seconds = 0.0;  // Wall time from the start of solve() to the end of the search.
+    double best_objective = 0.0;  // Objective of the returned plan, as the checker scores it.
+    unsigned seed = 0;            // Seed the run used; pass it back through SolverOptions::seed to repeat the run.
+    bool deadline_reached = false; // The time limit (or a cancellation) ended the search, or a region of a decomposed one.
+    double upper_bound = 0.0;     // Lowest bound on the objective found (see upper_bound.h); +infinity if none was ready.
+    double optimality_gap = 0.0;  // (upper_bound - best_objective) / upper_bound.
+    bool stopped_at_gap = false;  // The search ended early because the gap fell within SolverOptions::gap_tolerance.
+
+    long iterations() const { return construction_passes + alns_iterations; }
+};
+
+/**
+ * @brief Allocations solve() keeps between calls. Give each concurrent solve its own workspace;
+ * after solve() returns, dist holds the distance tables of the instance just solved.
+ */
+struct SolverWorkspace {
+    DistanceCache dist;
+};
+
+/**
+ * @brief Tuning knobs for the search.
+ */
+struct SolverOptions {
+    int num_threads = 1; // Worker threads for the multi-start search; 0 uses all hardware threads.
+    const CancellationToken* cancel = nullptr; // Stops the search early; the best plan so far is returned.
+    bool improve_routes = true; // Re-sequence each trip with 2-opt / Or-opt before charging its distance.
+    bool use_alns = true;       // Spend the budget left after construction on adaptive large neighbourhood search.
+    // Construction loads: false gives every drop its value-maximizing load from the payload optimizer
+    // and builds one plan per start; true tunes a global dry/perishable ratio over many passes instead.
+    bool ratio_walk = false;
+    SolverStats* stats = nullptr; // Receives work counters for benchmarking, if set.
+    Telemetry* telemetry = nullptr; // Receives phase timings, counters and the best-value trace, if set.
+    SolverWorkspace* workspace = nullptr; // Reused buffers for solving many instances in one process, if set.
+    // If set, every new best plan is validated and written here by a background thread (atomic
+    // replace), so a late or killed run still leaves its best plan; the search then uses the full
+    // time limit instead of 95% of it. solve() throws runtime_error if the final plan cannot be written.
+    std::string checkpoint_path;
+    long long seed = -1;        // Seed for every random choice; < 0 draws one from random_device.
+    // > 0 selects reproducible mode: the five classic starts run as independent pipelines (construction,
+    // then an even share of this many ALNS iterations), so a given seed yields the same Solution for
+    // any thread count. The time limit still applies as a safety net; a run it cuts short is not
+    // reproducible (see SolverStats::deadline_reached).
+    long iteration_budget = 0;
+    // Instances with at least this many villages and more than one home city are split into one
+    // region per home city first (see decomposition.h). The regions are solved side by side on the
+    // worker threads, and ALNS then repairs the merged plan across region borders. 0 never decomposes.
+    int decompose_min_villages = 10000;
+    // > 0: search for exactly this many seconds instead of a share of the instance's time limit.
+    double time_limit_seconds = 0.0;
+    // A plan for an earlier version of this instance (helicopters and villages matched by ID), if set.
+    // It is repaired to fit the instance (see warm_start.h) and the search starts from it instead of
+    // constructing plans or decomposing: every worker, or in reproducible mode a single run with the
+    // whole iteration budget, improves it with ALNS.
+    const Solution* warm_start = nullptr;
+    // Length of the nearest-village lists built at startup (see neighbor_lists.h). Construction
+    // extends a trip from the last village's list and scans every village in range only when
+    // nothing on it fits; ALNS draws its clusters from them. 0 always scans everything in range.
+    int candidate_neighbors = 16;
+    // Timed runs stop as soon as the best plan is within this relative gap of the upper bound
+    // tightened alongside the search (see upper_bound.h), leaving the rest of the time unused:
+    // 0 stops only on a plan proven optimal, < 0 never stops early. Reproducible runs never stop early.
+    double gap_tolerance = 0.0;
+};
 
 /**
  * @brief The main function to implement your search/optimization algorithm.
  * * @param problem A const reference to the parsed problem data.
+ * @param options Search settings (thread count, ...).
  * @return A Solution object containing the plan for all helicopters.
  */
-Solution solve(const ProblemData& problem);
+Solution solve(const ProblemData& problem, const SolverOptions& options = SolverOptions());
 
 #endif // SOLVER_H
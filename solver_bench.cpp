@@ -0,0 +1,132 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "structures.h"
+#include "io_handler.h"
+#include "solver.h"
+#include "scoring.h"
+#include "distance_cache.h"
+#include "instance_generator.h"
+
+using namespace std;
+
+/**
+ * @brief End-to-end benchmark over a ladder of generated instances.
+ *
+ * For every size it generates an instance, writes it, and then times parsing it back, solving it
+ * and writing the solution. It then scores the written file with the checker's rules. One JSON
+ * object is printed per size, with keys in a fixed order, so runs of two builds can be diffed.
+ * With --iterations the solver runs in reproducible mode (seeded with the instance seed), so the
+ * scores of two builds are comparable and only the timings should differ.
+ * Usage: solver_bench [--sizes 100,1000,...] [--threads N] [--time-limit MINUTES] [--seed S]
+ *        [--iterations N] [--clustering X] [--tightness X] [--dir DIR]
+ */
+
+static vector<int> parseSizes(const string& list) {
+    vector<int> sizes;
+    stringstream ss(list);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) sizes.push_back(atoi(item.c_str()));
+    }
+    return sizes;
+}
+
+static double millisSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    vector<int> sizes = {100, 1000, 10000, 100000, 1000000};
+    GeneratorParams base;
+    double time_limit = -1.0; // < 0: scale with the instance size
+    int num_threads = 1;
+    long iteration_budget = 0;
+    string dir = "bench_data";
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for option: " << arg << endl;
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--sizes") sizes = parseSizes(value);
+        else if (arg == "--threads") num_threads = atoi(value);
+        else if (arg == "--time-limit") time_limit = atof(value);
+        else if (arg == "--iterations") iteration_budget = atol(value);
+        else if (arg == "--seed") base.seed = strtoul(value, nullptr, 10);
+        else if (arg == "--clustering") base.clustering = atof(value);
+        else if (arg == "--tightness") base.tightness = atof(value);
+        else if (arg == "--dir") dir = value;
+        else {
+            cerr << "Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+    mkdir(dir.c_str(), 0755);
+
+    try {
+        for (int villages : sizes) {
+            GeneratorParams params = base;
+            params.num_villages = villages;
+            params.num_cities = max(2, min(100, villages / 2000));
+            params.num_helicopters = max(3, min(400, villages / 200));
+            params.time_limit_minutes = time_limit >= 0 ? time_limit : 0.02 * max(1.0, log10(max(villages, 1)));
+
+            const string stem = dir + "/v" + to_string(villages) + "_s" + to_string(params.seed);
+            const string input_file = stem + ".txt";
+            const string output_file = stem + ".out";
+
+            auto start = chrono::steady_clock::now();
+            writeInputData(input_file, generateInstance(params));
+            double generate_ms = millisSince(start);
+
+            start = chrono::steady_clock::now();
+            ProblemData problem = readInputData(input_file);
+            double parse_ms = millisSince(start);
+
+            SolverStats stats;
+            SolverOptions options;
+            options.num_threads = num_threads;
+            options.stats = &stats;
+            options.seed = params.seed;
+            options.iteration_budget = iteration_budget;
+            start = chrono::steady_clock::now();
+            Solution solution = solve(problem, options);
+            double solve_ms = millisSince(start);
+
+            start = chrono::steady_clock::now();
+            writeOutputData(output_file, solution);
+            double write_ms = millisSince(start);
+
+            const DistanceCache dist(problem, DistanceCache::Tables::None);
+            SolutionScorer scorer(problem, dist);
+            ScoreReport report = scorer.score(readSolutionData(output_file));
+
+            char line[1024];
+            snprintf(line, sizeof(line),
+                     "{\"villages\": %d, \"cities\": %d, \"helicopters\": %d, \"seed\": %u, \"threads\": %d, \"iteration_budget\": %ld, "
+                     "\"time_limit_s\": %.1f, \"generate_ms\": %.1f, \"parse_ms\": %.1f, \"solve_ms\": %.1f, \"write_ms\": %.1f, "
+                     "\"construction_passes\": %ld, \"alns_iterations\": %ld, \"iterations_per_sec\": %.1f, "
+                     "\"score\": %.6f, \"feasible\": %s, \"deadline_reached\": %s}",
+                     villages, params.num_cities, params.num_helicopters, params.seed, num_threads, iteration_budget,
+                     params.time_limit_minutes * 60.0, generate_ms, parse_ms, solve_ms, write_ms,
+                     stats.construction_passes, stats.alns_iterations,
+                     stats.search_seconds > 0 ? stats.iterations() / stats.search_seconds : 0.0,
+                     report.score(), report.feasible() ? "true" : "false", stats.deadline_reached ? "true" : "false");
+            cout << line << endl;
+        }
+    } catch (const exception& e) {
+        cerr << "An error occurred: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include "spatial_index.h"
+#include <cmath>
+#include <utility>
+
+using namespace std;
+
+VillageGrid::VillageGrid(const vector<Village>& villages, double villages_per_cell)
+    : min_x_(0), min_y_(0), cell_size_(1), inv_cell_size_(1), cols_(1), rows_(1), live_count_(villages.size()) {
+    const size_t n = villages.size();
+    if (n > 0) {
+        double max_x = villages[0].coords.x, max_y = villages[0].coords.y;
+        min_x_ = max_x;
+        min_y_ = max_y;
+        for (const auto& v : villages) {
+            min_x_ = min(min_x_, v.coords.x);
+            min_y_ = min(min_y_, v.coords.y);
+            max_x = max(max_x, v.coords.x);
+            max_y = max(max_y, v.coords.y);
+        }
+        double width = max_x - min_x_, height = max_y - min_y_;
+        double target_cells = max(1.0, n / villages_per_cell);
+        double extent = max(width, height);
+        if (extent > 0) {
+            double area = max(width, extent * 1e-3) * max(height, extent * 1e-3);
+            cell_size_ = sqrt(area / target_cells);
+        }
+        inv_cell_size_ = 1.0 / cell_size_;
+        cols_ = max(1, min(static_cast<int>(width * inv_cell_size_) + 1, 1 << 15));
+        rows_ = max(1, min(static_cast<int>(height * inv_cell_size_) + 1, 1 << 15));
+    }
+
+    const int num_cells = cols_ * rows_;
+    cell_of_.resize(n);
+    vector<int> counts(num_cells, 0);
+    for (size_t i = 0; i < n; ++i) {
+        int cx = cellCoord(villages[i].coords.x, min_x_, cols_);
+        int cy = cellCoord(villages[i].coords.y, min_y_, rows_);
+        cell_of_[i] = cy * cols_ + cx;
+        counts[cell_of_[i]]++;
+    }
+
+    cell_start_.assign(num_cells + 1, 0);
+    for (int c = 0; c < num_cells; ++c) cell_start_[c + 1] = cell_start_[c] + counts[c];
+    cell_live_ = counts;
+
+    items_.resize(n);
+    xs_.resize(n);
+    ys_.resize(n);
+    pos_.resize(n);
+    vector<int> fill(cell_start_.begin(), cell_start_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        int slot = fill[cell_of_[i]]++;
+        items_[slot] = static_cast<int>(i);
+        xs_[slot] = villages[i].coords.x;
+        ys_[slot] = villages[i].coords.y;
+        pos_[i] = slot;
+    }
+}
+
+void VillageGrid::reset() {
+    for (size_t c = 0; c + 1 < cell_start_.size(); ++c) {
+        cell_live_[c] = cell_start_[c + 1] - cell_start_[c];
+    }
+    live_count_ = items_.size();
+}
+
+void VillageGrid::remove(int village_idx) {
+    if (!contains(village_idx)) return;
+    int c = cell_of_[village_idx];
+    int slot = pos_[village_idx];
+    int last = cell_start_[c] + --cell_live_[c];
+    if (slot != last) {
+        int other = items_[last];
+        swap(items_[slot], items_[last]);
+        swap(xs_[slot], xs_[last]);
+        swap(ys_[slot], ys_[last]);
+        pos_[other] = slot;
+        pos_[village_idx] = last;
+    }
+    --live_count_;
+}
+
+void VillageGrid::nearest(const Point& p, int k, vector<int>& out) const {
+    out.clear();
+    if (k <= 0 || live_count_ == 0) return;
+
+    int cx = cellCoord(p.x, min_x_, cols_);
+    int cy = cellCoord(p.y, min_y_, rows_);
+    vector<pair<double, int>> found;
+
+    auto scanCell = [&](int x, int y) {
+        if (x < 0 || y < 0 || x >= cols_ || y >= rows_) return;
+        int c = y * cols_ + x;
+        int begin = cell_start_[c];
+        int end = begin + cell_live_[c];
+        for (int s = begin; s < end; ++s) {
+            double dx = xs_[s] - p.x, dy = ys_[s] - p.y;
+            found.emplace_back(dx * dx + dy * dy, items_[s]);
+        }
+    };
+
+    const int max_ring = max(cols_, rows_);
+    for (int ring = 0; ring <= max_ring; ++ring) {
+        if (ring == 0) {
+            scanCell(cx, cy);
+        } else {
+            for (int x = cx - ring; x <= cx + ring; ++x) {
+                scanCell(x, cy - ring);
+                scanCell(x, cy + ring);
+            }
+            for (int y = cy - ring + 1; y <= cy + ring - 1; ++y) {
+                scanCell(cx - ring, y);
+                scanCell(cx + ring, y);
+            }
+        }
+
+        bool covers_grid = cx - ring <= 0 && cy - ring <= 0 && cx + ring >= cols_ - 1 && cy + ring >= rows_ - 1;
+        if (static_cast<int>(found.size()) >= k || covers_grid) {
+            // Anything not yet scanned lies outside the (2*ring+1)^2 block around p's cell.
+            double left = min_x_ + (cx - ring) * cell_size_, right = min_x_ + (cx + ring + 1) * cell_size_;
+            double bottom = min_y_ + (cy - ring) * cell_size_, top = min_y_ + (cy + ring + 1) * cell_size_;
+            double bound = min(min(p.x - left, right - p.x), min(p.y - bottom, top - p.y));
+            size_t keep = min(found.size(), static_cast<size_t>(k));
+            nth_element(found.begin(), found.begin() + (keep - 1), found.end());
+            double kth = found[keep - 1].first;
+            if (covers_grid || (bound > 0 && kth < bound * bound)) break;
+        }
+    }
+
+    sort(found.begin(), found.end());
+    size_t keep = min(found.size(), static_cast<size_t>(k));
+    out.reserve(keep);
+    for (size_t i = 0; i < keep; ++i) out.push_back(found[i].second);
+}
@@ -0,0 +1,88 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <vector>
+#include <algorithm>
+#include "structures.h"
+
+/**
+ * @brief Uniform grid over Village::coords holding the set of still-unserved villages.
+ *
+ * Villages are bucketed into square cells sized for a few villages per cell. Each cell's
+ * members sit contiguously (with their coordinates) in one flat array, live members first,
+ * so removal is an O(1) swap with the cell's last live entry and reset() simply restores
+ * the per-cell live counts. Indices are 0-based positions in ProblemData::villages.
+ */
+class VillageGrid {
+public:
+    explicit VillageGrid(const vector<Village>& villages, double villages_per_cell = 2.0);
+
+    /**
+     * @brief Marks every village as unserved again. O(number of cells).
+     */
+    void reset();
+
+    /**
+     * @brief Drops a village from all future queries. O(1); no-op if already removed.
+     */
+    void remove(int village_idx);
+
+    bool contains(int village_idx) const {
+        int pos = pos_[village_idx];
+        return pos - cell_start_[cell_of_[village_idx]] < cell_live_[cell_of_[village_idx]];
+    }
+
+    size_t size() const { return live_count_; }
+
+    /**
+     * @brief Calls fn(village_idx) for every live village within radius r of p.
+     * The radius is widened by a relative 1e-9 so no village accepted by an exact
+     * distance() test at r is ever missed; callers apply their own exact checks.
+     */
+    template <typename F>
+    void forEachWithin(const Point& p, double r, F&& fn) const {
+        if (live_count_ == 0 || !(r >= 0)) return;
+        double r_wide = r * (1.0 + 1e-9) + 1e-12;
+        double r2 = r_wide * r_wide;
+        int x0 = cellCoord(p.x - r_wide, min_x_, cols_);
+        int x1 = cellCoord(p.x + r_wide, min_x_, cols_);
+        int y0 = cellCoord(p.y - r_wide, min_y_, rows_);
+        int y1 = cellCoord(p.y + r_wide, min_y_, rows_);
+        for (int cy = y0; cy <= y1; ++cy) {
+            for (int cx = x0; cx <= x1; ++cx) {
+                int c = cy * cols_ + cx;
+                int begin = cell_start_[c];
+                int end = begin + cell_live_[c];
+                for (int k = begin; k < end; ++k) {
+                    double dx = xs_[k] - p.x, dy = ys_[k] - p.y;
+                    if (dx * dx + dy * dy <= r2) fn(items_[k]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief The k live villages closest to p, nearest first (ties broken by index).
+     */
+    void nearest(const Point& p, int k, vector<int>& out) const;
+
+private:
+    int cellCoord(double v, double lo, int n) const {
+        double c = (v - lo) * inv_cell_size_;
+        if (!(c >= 0)) return 0;
+        if (c >= n) return n - 1;
+        return static_cast<int>(c);
+    }
+
+    double min_x_, min_y_, cell_size_, inv_cell_size_;
+    int cols_, rows_;
+    size_t live_count_;
+    vector<int> cell_start_;   // first slot of each cell in items_ (size cells + 1)
+    vector<int> cell_live_;    // live members at the front of each cell
+    vector<int> cell_of_;      // village -> cell
+    vector<int> pos_;          // village -> slot in items_
+    vector<int> items_;        // village indices grouped by cell
+    vector<double> xs_, ys_;   // coordinates in items_ order
+};
+
+#endif // SPATIAL_INDEX_H
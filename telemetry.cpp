@@ -0,0 +1,101 @@
+#include "telemetry.h"
+
+#ifndef SOLVER_NO_TELEMETRY
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const char* const kPhaseNames[] = {"first_village_scan", "insertion_scan", "route_improvement", "evaluation", "alns", "validation", "regions"};
+const char* const kCounterNames[] = {"construction_passes", "trips_built", "candidate_evaluations", "alns_iterations", "best_updates"};
+
+static_assert(sizeof(kPhaseNames) / sizeof(kPhaseNames[0]) == static_cast<size_t>(Phase::COUNT), "one name per phase");
+static_assert(sizeof(kCounterNames) / sizeof(kCounterNames[0]) == static_cast<size_t>(Counter::COUNT), "one name per counter");
+
+double seconds(chrono::steady_clock::duration d) {
+    return chrono::duration<double>(d).count();
+}
+
+} // namespace
+
+void Telemetry::merge(const TelemetryShard& shard) {
+    if (!shard.enabled()) return;
+    lock_guard<mutex> lock(mutex_);
+    for (int i = 0; i < static_cast<int>(Counter::COUNT); ++i) counters_[i] += shard.counters_[i];
+    for (int i = 0; i < static_cast<int>(Phase::COUNT); ++i) {
+        phase_time_[i] += shard.phase_time_[i];
+        phase_calls_[i] += shard.phase_calls_[i];
+    }
+    starts_.insert(starts_.end(), shard.starts_.begin(), shard.starts_.end());
+    // Each shard's decisions are in time order; keep the merged log in time order too.
+    const size_t merged = allocations_.size();
+    allocations_.insert(allocations_.end(), shard.allocations_.begin(), shard.allocations_.end());
+    inplace_merge(allocations_.begin(), allocations_.begin() + merged, allocations_.end(),
+                  [](const AllocationRecord& a, const AllocationRecord& b) { return a.at_seconds < b.at_seconds; });
+}
+
+void Telemetry::recordBest(double value, const char* source) {
+    double t = seconds(chrono::steady_clock::now() - start_);
+    lock_guard<mutex> lock(mutex_);
+    counters_[static_cast<int>(Counter::BEST_UPDATES)]++;
+    trace_.push_back({t, value, source});
+}
+
+void Telemetry::note(const string& key, double value) {
+    lock_guard<mutex> lock(mutex_);
+    notes_[key] = value;
+}
+
+void Telemetry::writeJson(const string& filename) const {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Error: Could not open stats file " + filename);
+    }
+    lock_guard<mutex> lock(mutex_);
+    file << setprecision(15);
+
+    file << "{\n  \"summary\": {";
+    bool first = true;
+    for (const auto& entry : notes_) {
+        file << (first ? "" : ",") << "\n    \"" << entry.first << "\": " << entry.second;
+        first = false;
+    }
+
+    // Phase times are summed over workers, so with several threads they can exceed wall time.
+    file << "\n  },\n  \"phases\": {";
+    for (int i = 0; i < static_cast<int>(Phase::COUNT); ++i) {
+        file << (i ? "," : "") << "\n    \"" << kPhaseNames[i] << "\": {\"seconds\": " << seconds(phase_time_[i]) << ", \"calls\": " << phase_calls_[i] << "}";
+    }
+
+    file << "\n  },\n  \"counters\": {";
+    for (int i = 0; i < static_cast<int>(Counter::COUNT); ++i) {
+        file << (i ? "," : "") << "\n    \"" << kCounterNames[i] << "\": " << counters_[i];
+    }
+
+    file << "\n  },\n  \"starts\": [";
+    for (size_t i = 0; i < starts_.size(); ++i) {
+        const StartRecord& s = starts_[i];
+        file << (i ? "," : "") << "\n    {\"ratio\": " << s.ratio << ", \"passes\": " << s.passes << ", \"candidate_evaluations\": " << s.candidate_evaluations
+             << ", \"best_value\": " << s.best_value << ", \"seconds\": " << s.seconds << "}";
+    }
+
+    file << "\n  ],\n  \"allocations\": [";
+    for (size_t i = 0; i < allocations_.size(); ++i) {
+        const AllocationRecord& a = allocations_[i];
+        file << (i ? "," : "") << "\n    {\"at_seconds\": " << a.at_seconds << ", \"worker\": " << a.worker << ", \"arm\": \"" << a.arm
+             << "\", \"seconds\": " << a.seconds << ", \"gain\": " << a.gain << ", \"rate\": " << a.rate << "}";
+    }
+
+    file << "\n  ],\n  \"best_trace\": [";
+    for (size_t i = 0; i < trace_.size(); ++i) {
+        file << (i ? "," : "") << "\n    {\"seconds\": " << trace_[i].seconds << ", \"value\": " << trace_[i].value << ", \"source\": \"" << trace_[i].source << "\"}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+#endif // SOLVER_NO_TELEMETRY
@@ -0,0 +1,186 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Low-overhead solver instrumentation: per-phase timers, work counters, one record per
+ * start ratio and per portfolio decision, and a trace of the best value over time, dumped as JSON.
+ *
+ * Workers record into their own TelemetryShard without locking and merge it into the shared
+ * Telemetry once, when they finish. Building with -DSOLVER_NO_TELEMETRY turns every recording
+ * call into an empty inline function, so the instrumentation compiles away entirely.
+ */
+
+enum class Phase {
+    FIRST_VILLAGE_SCAN, // Choosing the first village of a trip.
+    INSERTION_SCAN,     // Extending a trip village by village.
+    ROUTE_IMPROVEMENT,  // 2-opt / Or-opt re-sequencing of finished trips.
+    EVALUATION,         // Exact scoring of constructed plans.
+    ALNS,               // Large neighbourhood search, end to end.
+    VALIDATION,         // Final feasibility pass over the returned plan.
+    REGIONS,            // Solving the regions of a decomposed instance, end to end.
+    COUNT
+};
+
+enum class Counter {
+    CONSTRUCTION_PASSES,   // Complete plans built by greedy construction.
+    TRIPS_BUILT,
+    CANDIDATE_EVALUATIONS, // Villages priced by the first-village and insertion scans.
+    ALNS_ITERATIONS,
+    BEST_UPDATES,          // Times the shared best plan improved.
+    COUNT
+};
+
+/**
+ * @brief Work done by one start of the construction (one start ratio of the ratio walk).
+ */
+struct StartRecord {
+    double ratio = 0.0;
+    long passes = 0;
+    long candidate_evaluations = 0;
+    double best_value = 0.0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief One pull of the portfolio scheduler: which strategy a worker ran, when, and what it gained.
+ */
+struct AllocationRecord {
+    double at_seconds = 0.0; // When the pull started, since the start of the solve.
+    int worker = 0;
+    const char* arm = "";
+    double seconds = 0.0;
+    double gain = 0.0;       // How much the pull raised the best value.
+    double rate = 0.0;       // The arm's discounted gain per second after the pull.
+};
+
+#ifndef SOLVER_NO_TELEMETRY
+
+/**
+ * @brief One worker's measurements. Disabled shards (no Telemetry attached) skip the clock reads.
+ */
+class TelemetryShard {
+public:
+    explicit TelemetryShard(bool enabled) : enabled_(enabled) {}
+
+    bool enabled() const { return enabled_; }
+    void add(Counter counter, long n) { counters_[static_cast<int>(counter)] += n; }
+    void addTime(Phase phase, std::chrono::steady_clock::duration elapsed) {
+        phase_time_[static_cast<int>(phase)] += elapsed;
+        phase_calls_[static_cast<int>(phase)]++;
+    }
+    void recordStart(const StartRecord& record) {
+        if (enabled_) starts_.push_back(record);
+    }
+    void recordAllocation(const AllocationRecord& record) {
+        if (enabled_) allocations_.push_back(record);
+    }
+
+private:
+    friend class Telemetry;
+
+    bool enabled_;
+    long counters_[static_cast<int>(Counter::COUNT)] = {};
+    std::chrono::steady_clock::duration phase_time_[static_cast<int>(Phase::COUNT)] = {};
+    long phase_calls_[static_cast<int>(Phase::COUNT)] = {};
+    std::vector<StartRecord> starts_;
+    std::vector<AllocationRecord> allocations_;
+};
+
+/**
+ * @brief Charges the lifetime of the scope to a phase.
+ */
+class PhaseTimer {
+public:
+    PhaseTimer(TelemetryShard& shard, Phase phase) : shard_(shard), phase_(phase) {
+        if (shard_.enabled()) start_ = std::chrono::steady_clock::now();
+    }
+    ~PhaseTimer() {
+        if (shard_.enabled()) shard_.addTime(phase_, std::chrono::steady_clock::now() - start_);
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    TelemetryShard& shard_;
+    Phase phase_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief Measurements of a whole solve, merged from every worker's shard. Thread-safe.
+ */
+class Telemetry {
+public:
+    static constexpr bool kEnabled = true;
+
+    Telemetry() : start_(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Restarts the clock the best-value trace is measured against.
+     */
+    void start() { start_ = std::chrono::steady_clock::now(); }
+
+    void merge(const TelemetryShard& shard);
+    void recordBest(double value, const char* source);
+    void note(const std::string& key, double value);
+
+    /**
+     * @brief Writes everything recorded so far as a JSON object.
+     */
+    void writeJson(const std::string& filename) const;
+
+private:
+    struct TracePoint {
+        double seconds;
+        double value;
+        const char* source;
+    };
+
+    mutable std::mutex mutex_;
+    std::chrono::steady_clock::time_point start_;
+    long counters_[static_cast<int>(Counter::COUNT)] = {};
+    std::chrono::steady_clock::duration phase_time_[static_cast<int>(Phase::COUNT)] = {};
+    long phase_calls_[static_cast<int>(Phase::COUNT)] = {};
+    std::vector<StartRecord> starts_;
+    std::vector<AllocationRecord> allocations_;
+    std::vector<TracePoint> trace_;
+    std::map<std::string, double> notes_;
+};
+
+#else // SOLVER_NO_TELEMETRY
+
+class TelemetryShard {
+public:
+    explicit TelemetryShard(bool) {}
+    bool enabled() const { return false; }
+    void add(Counter, long) {}
+    void addTime(Phase, std::chrono::steady_clock::duration) {}
+    void recordStart(const StartRecord&) {}
+    void recordAllocation(const AllocationRecord&) {}
+};
+
+class PhaseTimer {
+public:
+    PhaseTimer(TelemetryShard&, Phase) {}
+};
+
+class Telemetry {
+public:
+    static constexpr bool kEnabled = false;
+    void start() {}
+    void merge(const TelemetryShard&) {}
+    void recordBest(double, const char*) {}
+    void note(const std::string&, double) {}
+    void writeJson(const std::string&) const {}
+};
+
+#endif // SOLVER_NO_TELEMETRY
+
+#endif // TELEMETRY_H
@@ -0,0 +1,144 @@
+#include "upper_bound.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace {
+
+const int DRY = 0, PER = 1, OTH = 2;
+
+} // namespace
+
+UpperBound::UpperBound(const ProblemData& problem, const DistanceCache& dist)
+    : problem_(problem),
+      dist_(dist),
+      multipliers_(problem.helicopters.size(), 0.0),
+      distance_used_(problem.helicopters.size(), 0.0),
+      best_bound_(numeric_limits<double>::infinity()) {
+    food_value_[0] = problem.packages[DRY].value;
+    food_weight_[0] = problem.packages[DRY].weight;
+    food_value_[1] = problem.packages[PER].value;
+    food_weight_[1] = problem.packages[PER].weight;
+    for (const auto& helicopter : problem.helicopters) {
+        city_rows_.push_back(dist.cityRow(helicopter.home_city_id - 1));
+        if (helicopter.fixed_cost < 0.0 || helicopter.alpha < 0.0) finite_ = false;
+    }
+}
+
+bool UpperBound::evaluate(const Deadline& deadline, double& bound) {
+    const int num_villages = static_cast<int>(problem_.villages.size());
+    const double other_value = problem_.packages[OTH].value, other_weight = problem_.packages[OTH].weight;
+
+    // Per village: net value of the best food unit and of an other-supplies unit, the helicopter
+    // that earns it and the weight of that food unit. Nets start at 0 since no unit must be sent.
+    food_net_.assign(num_villages, 0.0);
+    other_net_.assign(num_villages, 0.0);
+    food_by_.assign(num_villages, -1);
+    other_by_.assign(num_villages, -1);
+    food_unit_weight_.assign(num_villages, 0.0);
+
+    for (size_t h = 0; h < problem_.helicopters.size(); ++h) {
+        const Helicopter& helicopter = problem_.helicopters[h];
+        if (helicopter.weight_capacity <= 0.0) continue;
+        const double* row = city_rows_[h];
+        const int city = helicopter.home_city_id - 1;
+        // Widened like the grid's radius queries, so rounding never drops a reachable village.
+        const double reach = min(helicopter.distance_capacity, problem_.d_max) / 2.0 * (1.0 + 1e-9) + 1e-12;
+        const double per_distance = 2.0 * (helicopter.alpha + multipliers_[h]) / helicopter.weight_capacity;
+        const double per_weight = helicopter.fixed_cost / helicopter.weight_capacity;
+        for (int block = 0; block < num_villages; block += kVillagesPerCheck) {
+            if (deadline.expired()) {
+                interrupted_ = true;
+                return false;
+            }
+            const int block_end = min(num_villages, block + kVillagesPerCheck);
+            for (int v = block; v < block_end; ++v) {
+                const double d = row ? row[v] : dist_.cityToVillage(city, v);
+                if (d > reach) continue;
+                const double charge = per_weight + per_distance * d; // Per unit of weight.
+                for (int t = 0; t < 2; ++t) {
+                    const double net = food_value_[t] - food_weight_[t] * charge;
+                    if (net > food_net_[v]) {
+                        food_net_[v] = net;
+                        food_by_[v] = static_cast<int>(h);
+                        food_unit_weight_[v] = food_weight_[t];
+                    }
+                }
+                const double net = other_value - other_weight * charge;
+                if (net > other_net_[v]) {
+                    other_net_[v] = net;
+                    other_by_[v] = static_cast<int>(h);
+                }
+            }
+        }
+    }
+
+    bound = 0.0;
+    fill(distance_used_.begin(), distance_used_.end(), 0.0);
+    for (size_t h = 0; h < multipliers_.size(); ++h) bound += multipliers_[h] * problem_.d_max;
+    const auto cityDistance = [&](int h, int v) {
+        return city_rows_[h] ? city_rows_[h][v] : dist_.cityToVillage(problem_.helicopters[h].home_city_id - 1, v);
+    };
+    for (int v = 0; v < num_villages; ++v) {
+        const double food_units = 9.0 * problem_.villages[v].population;
+        const double other_units = problem_.villages[v].population;
+        if (food_by_[v] >= 0) {
+            const int h = food_by_[v];
+            bound += food_units * food_net_[v];
+            distance_used_[h] += food_units * food_unit_weight_[v] * 2.0 * cityDistance(h, v) / problem_.helicopters[h].weight_capacity;
+        }
+        if (other_by_[v] >= 0) {
+            const int h = other_by_[v];
+            bound += other_units * other_net_[v];
+            distance_used_[h] += other_units * other_weight * 2.0 * cityDistance(h, v) / problem_.helicopters[h].weight_capacity;
+        }
+    }
+    return true;
+}
+
+bool UpperBound::tighten(double best_known, const Deadline& deadline) {
+    if (!finite_ || interrupted_ || steps_ >= kMaxSteps || step_scale_ < kMinStepScale) return false;
+    if (!evaluated_) {
+        if (!evaluate(deadline, current_bound_)) return false;
+        best_bound_ = current_bound_;
+        evaluated_ = true;
+        return true;
+    }
+    if (static_cast<double>(problem_.helicopters.size()) * problem_.villages.size() > kMaxTightenWork) return false;
+    // The empty plan is always feasible, so no plan is needed to aim the step.
+    const double target = max(best_known, 0.0);
+    if (best_bound_ <= target) return false;
+
+    // Subgradient of the dual: the DMax slack each helicopter's charged units leave. Components
+    // that would push a zero multiplier below zero are left out of the step.
+    double norm = 0.0;
+    for (size_t h = 0; h < multipliers_.size(); ++h) {
+        const double slack = problem_.d_max - distance_used_[h];
+        if (multipliers_[h] > 0.0 || slack < 0.0) norm += slack * slack;
+    }
+    if (norm <= 0.0) return false;
+
+    const double step = step_scale_ * (current_bound_ - target) / norm;
+    for (size_t h = 0; h < multipliers_.size(); ++h) {
+        multipliers_[h] = max(0.0, multipliers_[h] - step * (problem_.d_max - distance_used_[h]));
+    }
+    if (!evaluate(deadline, current_bound_)) return false;
+    ++steps_;
+
+    if (current_bound_ < best_bound_) {
+        best_bound_ = current_bound_;
+        since_lower_ = 0;
+    } else if (++since_lower_ >= kPatience) {
+        step_scale_ /= 2.0;
+        since_lower_ = 0;
+    }
+    return true;
+}
+
+double optimalityGap(double bound, double objective) {
+    if (!(bound < numeric_limits<double>::infinity())) return numeric_limits<double>::infinity();
+    if (objective >= bound) return 0.0;
+    if (bound <= 0.0) return numeric_limits<double>::infinity();
+    return (bound - objective) / bound;
+}
@@ -0,0 +1,85 @@
+#ifndef UPPER_BOUND_H
+#define UPPER_BOUND_H
+
+#include <vector>
+#include "structures.h"
+#include "distance_cache.h"
+#include "deadline.h"
+
+/**
+ * @brief Upper bound on the objective of any feasible plan, tightened step by step.
+ *
+ * A trip from city c costs F + alpha * D and carries at most the helicopter's capacity W, and D is
+ * at least twice the distance to its farthest village. Each unit of weight w it drops at village v
+ * can therefore be charged w * (F + 2 * alpha * d(c, v)) / W of its cost and w * 2 * d(c, v) / W of
+ * its length without undercharging the trip. Relaxing the plan to these per-unit charges leaves a
+ * fractional knapsack per village: units of the best food type and of other supplies, up to the
+ * village's need, from whichever helicopter that can reach it delivers them cheapest.
+ *
+ * Each helicopter's DMax limit on the units charged to it is priced with a Lagrange multiplier, so
+ * every multiplier vector gives a valid bound. The first tighten() evaluates the bound with all
+ * multipliers at zero, each later one takes a subgradient step on them, and value() keeps the
+ * lowest bound seen: +infinity until the first evaluation completes. Helicopters with a negative
+ * fixed cost or alpha break the charging argument; the bound then stays +infinity.
+ *
+ * Every evaluation of the bound costs O(helicopters * villages). Evaluations check the deadline
+ * every few thousand villages, and one that runs out of time is dropped, so the bound stays at the
+ * last one that completed. Above kMaxTightenWork helicopter-village pairs only the zero-multiplier
+ * bound is computed.
+ */
+class UpperBound {
+public:
+    /**
+     * @brief Only gathers the instance's data; the first tighten() evaluates the bound.
+     */
+    UpperBound(const ProblemData& problem, const DistanceCache& dist);
+
+    double value() const { return best_bound_; }
+    int steps() const { return steps_; }
+
+    /**
+     * @brief The first call evaluates the zero-multiplier bound. Every later call takes one
+     * subgradient step, sized by the gap to best_known (the best plan's objective).
+     * @return False once further steps are not worth taking: the step size has decayed, the
+     *         bound meets best_known, the bound is not finite, the instance is above the size
+     *         cap, or an evaluation was cut short by the deadline.
+     */
+    bool tighten(double best_known, const Deadline& deadline);
+
+private:
+    static constexpr int kMaxSteps = 200;
+    static constexpr double kMinStepScale = 1e-3;
+    static constexpr int kPatience = 5; // Steps without a lower bound before the step size halves.
+    static constexpr double kMaxTightenWork = 2e7;  // Helicopter-village pairs; about 50 ms per step.
+    static constexpr int kVillagesPerCheck = 4096;  // Villages evaluated between deadline checks.
+
+    // Evaluates the bound at multipliers_ into bound, filling distance_used_ with each helicopter's
+    // charged length. False, with bound untouched, if the deadline passed first.
+    bool evaluate(const Deadline& deadline, double& bound);
+
+    const ProblemData& problem_;
+    const DistanceCache& dist_;
+    // Per helicopter: distances from its home city, or nullptr if the cache computes them.
+    std::vector<const double*> city_rows_;
+    std::vector<double> multipliers_, distance_used_;
+    // Scratch of evaluate(), per village: the best net per unit and the helicopter earning it.
+    std::vector<double> food_net_, other_net_, food_unit_weight_;
+    std::vector<int> food_by_, other_by_;
+    double food_value_[2], food_weight_[2];
+    double current_bound_ = 0.0; // At the current multipliers.
+    double best_bound_;
+    double step_scale_ = 1.0;
+    int steps_ = 0, since_lower_ = 0;
+    bool finite_ = true;
+    bool interrupted_ = false;
+    bool evaluated_ = false; // The zero-multiplier bound is in best_bound_.
+};
+
+/**
+ * @brief Relative optimality gap of a plan with the given objective: (bound - objective) / bound,
+ * or 0 if the objective reaches the bound. +infinity if the bound is not finite, or not positive
+ * while above the objective.
+ */
+double optimalityGap(double bound, double objective);
+
+#endif // UPPER_BOUND_H
@@ -0,0 +1,252 @@
+#include "village_scan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VILLAGE_SCAN_X86 1
+#include <immintrin.h>
+#else
+#define VILLAGE_SCAN_X86 0
+#endif
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Per-scan constants, hoisted out of the candidate loop.
+ */
+struct ScanConstants {
+    int max_food;        // Food units a full helicopter carries at the scan's average food weight.
+    double weight_limit; // Weight capacity plus the solver's feasibility tolerance.
+    bool can_send_other;
+};
+
+ScanConstants scanConstants(const FirstVillageScan& scan) {
+    int max_food = scan.payload ? 0 : static_cast<int>(scan.weight_capacity / scan.avg_food_weight);
+    return {max_food, scan.weight_capacity + 1e-9, scan.packages[2].weight > 1e-9};
+}
+
+// Equal values go to the lower index; village -1 only ever loses.
+inline bool beats(double net_value, int village, const FirstVillageChoice& best) {
+    return net_value > best.net_value || (net_value == best.net_value && best.village != -1 && village < best.village);
+}
+
+/**
+ * @brief Prices the trip home -> i -> home with the ratio walk's load.
+ * @return False if the village has no demand left or the trip does not fit.
+ */
+inline bool priceCandidate(const FirstVillageScan& scan, const ScanConstants& k, int i, double& net_value, int& dry_units, int& perishable_units, int& other_units) {
+    if (scan.rem_food[i] <= 0 && scan.rem_other[i] <= 0) return false;
+
+    double trip_distance = 2.0 * scan.city_distance[i];
+    if (trip_distance > scan.distance_capacity || trip_distance > scan.distance_budget) return false;
+
+    if (scan.payload) {
+        Payload load = scan.payload->best(scan.weight_capacity, scan.rem_food[i], scan.rem_other[i]);
+        dry_units = load.dry;
+        perishable_units = load.perishable;
+        other_units = load.other;
+        double total_weight = dry_units * scan.packages[0].weight + perishable_units * scan.packages[1].weight + other_units * scan.packages[2].weight;
+        if (total_weight > k.weight_limit) return false;
+        double value = villageDeliveryValue(scan.population[i], dry_units, perishable_units, other_units, scan.packages);
+        net_value = value - (scan.fixed_cost + scan.alpha * trip_distance);
+        return true;
+    }
+
+    int food_to_send = min(scan.rem_food[i], k.max_food);
+    dry_units = static_cast<int>(food_to_send * scan.dry_ratio);
+    perishable_units = food_to_send - dry_units;
+
+    double food_weight = dry_units * scan.packages[0].weight + perishable_units * scan.packages[1].weight;
+    if (food_weight > k.weight_limit) return false;
+
+    double rem_weight = scan.weight_capacity - food_weight;
+    other_units = 0;
+    if (k.can_send_other && rem_weight > 1e-9) {
+        other_units = min(scan.rem_other[i], static_cast<int>(rem_weight / scan.packages[2].weight));
+        other_units = max(0, other_units);
+    }
+
+    double total_weight = food_weight + other_units * scan.packages[2].weight;
+    if (total_weight > k.weight_limit) return false;
+
+    double value = villageDeliveryValue(scan.population[i], dry_units, perishable_units, other_units, scan.packages);
+    double cost = scan.fixed_cost + scan.alpha * trip_distance;
+    net_value = value - cost;
+    return true;
+}
+
+void scanScalarRange(const FirstVillageScan& scan, const ScanConstants& k, const int* candidates, size_t count, FirstVillageChoice& best) {
+    for (size_t c = 0; c < count; ++c) {
+        const int i = candidates[c];
+        double net_value;
+        int dry_units, perishable_units, other_units;
+        if (!priceCandidate(scan, k, i, net_value, dry_units, perishable_units, other_units)) continue;
+        if (beats(net_value, i, best)) best = {i, net_value, dry_units, perishable_units, other_units};
+    }
+}
+
+} // namespace
+
+FirstVillageChoice scanFirstVillageScalar(const FirstVillageScan& scan, const int* candidates, size_t count) {
+    FirstVillageChoice best;
+    if (!scan.payload && scan.avg_food_weight < 1e-9) return best;
+    scanScalarRange(scan, scanConstants(scan), candidates, count, best);
+    return best;
+}
+
+#if VILLAGE_SCAN_X86
+
+namespace {
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// Widens a 4 x int32 lane mask to a 4 x double lane mask.
+AVX2_TARGET inline __m256d widenMask(__m128i mask) {
+    return _mm256_castsi256_pd(_mm256_cvtepi32_epi64(mask));
+}
+
+// Narrows a 4 x double lane mask to a 4 x int32 lane mask.
+AVX2_TARGET inline __m128i narrowMask(__m256d mask) {
+    const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+    return _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_castpd_si256(mask), low_halves));
+}
+
+// !(a > b), true for NaN like the scalar "skip if a > b" tests.
+AVX2_TARGET inline __m256d notGreater(__m256d a, __m256d b) {
+    return _mm256_cmp_pd(a, b, _CMP_NGT_UQ);
+}
+
+} // namespace
+
+/*
+ * Same operations as priceCandidate, in the same order and without fused multiply-adds, on four
+ * candidates at a time: the int arithmetic runs on 4 x int32 and the double arithmetic on
+ * 4 x double, converting between them exactly as the scalar casts do. Each lane keeps its own
+ * best, and the lanes are folded with the same order as the scalar scan at the end.
+ */
+AVX2_TARGET FirstVillageChoice scanFirstVillageAvx2(const FirstVillageScan& scan, const int* candidates, size_t count) {
+    FirstVillageChoice best;
+    if (scan.avg_food_weight < 1e-9) return best;
+    const ScanConstants k = scanConstants(scan);
+
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d zero_d = _mm256_setzero_pd();
+    const __m256d epsilon = _mm256_set1_pd(1e-9);
+    const __m256d distance_capacity = _mm256_set1_pd(scan.distance_capacity);
+    const __m256d distance_budget = _mm256_set1_pd(scan.distance_budget);
+    const __m256d weight_capacity = _mm256_set1_pd(scan.weight_capacity);
+    const __m256d weight_limit = _mm256_set1_pd(k.weight_limit);
+    const __m256d dry_ratio = _mm256_set1_pd(scan.dry_ratio);
+    const __m256d dry_weight = _mm256_set1_pd(scan.packages[0].weight);
+    const __m256d perishable_weight = _mm256_set1_pd(scan.packages[1].weight);
+    const __m256d other_weight = _mm256_set1_pd(scan.packages[2].weight);
+    const __m256d dry_value = _mm256_set1_pd(scan.packages[0].value);
+    const __m256d perishable_value = _mm256_set1_pd(scan.packages[1].value);
+    const __m256d other_value = _mm256_set1_pd(scan.packages[2].value);
+    const __m256d fixed_cost = _mm256_set1_pd(scan.fixed_cost);
+    const __m256d alpha = _mm256_set1_pd(scan.alpha);
+    const __m128i zero_i = _mm_setzero_si128();
+    const __m128i nine = _mm_set1_epi32(9);
+    const __m128i max_food = _mm_set1_epi32(k.max_food);
+    const __m128i all_lanes_i = _mm_set1_epi32(-1);
+    const __m256d all_lanes_d = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    __m256d lane_net = _mm256_setzero_pd();
+    __m128i lane_village = _mm_set1_epi32(-1);
+
+    size_t c = 0;
+    for (; c + 4 <= count; c += 4) {
+        const __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidates + c));
+        // Masked gathers with every lane enabled: the unmasked forms trip -Wmaybe-uninitialized in GCC 12.
+        const __m128i rem_food = _mm_mask_i32gather_epi32(zero_i, scan.rem_food, idx, all_lanes_i, 4);
+        const __m128i rem_other = _mm_mask_i32gather_epi32(zero_i, scan.rem_other, idx, all_lanes_i, 4);
+        const __m128i population = _mm_mask_i32gather_epi32(zero_i, scan.population, idx, all_lanes_i, 4);
+        const __m256d city_distance = _mm256_mask_i32gather_pd(zero_d, scan.city_distance, idx, all_lanes_d, 8);
+
+        __m256d ok = widenMask(_mm_or_si128(_mm_cmpgt_epi32(rem_food, zero_i), _mm_cmpgt_epi32(rem_other, zero_i)));
+
+        const __m256d trip_distance = _mm256_mul_pd(two, city_distance);
+        ok = _mm256_and_pd(ok, notGreater(trip_distance, distance_capacity));
+        ok = _mm256_and_pd(ok, notGreater(trip_distance, distance_budget));
+
+        const __m128i food_to_send = _mm_min_epi32(rem_food, max_food);
+        const __m128i dry_units = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(food_to_send), dry_ratio));
+        const __m128i perishable_units = _mm_sub_epi32(food_to_send, dry_units);
+
+        const __m256d food_weight = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(dry_units), dry_weight),
+                                                  _mm256_mul_pd(_mm256_cvtepi32_pd(perishable_units), perishable_weight));
+        ok = _mm256_and_pd(ok, notGreater(food_weight, weight_limit));
+
+        const __m256d rem_weight = _mm256_sub_pd(weight_capacity, food_weight);
+        __m128i other_units = zero_i;
+        if (k.can_send_other) {
+            const __m128i fits = _mm256_cvttpd_epi32(_mm256_div_pd(rem_weight, other_weight));
+            other_units = _mm_max_epi32(zero_i, _mm_min_epi32(rem_other, fits));
+            other_units = _mm_and_si128(other_units, narrowMask(_mm256_cmp_pd(rem_weight, epsilon, _CMP_GT_OQ)));
+        }
+        const __m256d other_units_d = _mm256_cvtepi32_pd(other_units);
+
+        const __m256d total_weight = _mm256_add_pd(food_weight, _mm256_mul_pd(other_units_d, other_weight));
+        ok = _mm256_and_pd(ok, notGreater(total_weight, weight_limit));
+
+        // villageDeliveryValue
+        const __m128i effective_food = _mm_min_epi32(_mm_add_epi32(dry_units, perishable_units), _mm_mullo_epi32(nine, population));
+        const __m128i effective_other = _mm_min_epi32(other_units, population);
+        const __m128i effective_perishable = _mm_min_epi32(perishable_units, effective_food);
+        const __m128i effective_dry = _mm_min_epi32(dry_units, _mm_sub_epi32(effective_food, effective_perishable));
+        __m256d food_value = _mm256_add_pd(zero_d, _mm256_mul_pd(_mm256_cvtepi32_pd(effective_perishable), perishable_value));
+        food_value = _mm256_add_pd(food_value, _mm256_mul_pd(_mm256_cvtepi32_pd(effective_dry), dry_value));
+        food_value = _mm256_and_pd(food_value, widenMask(_mm_cmpgt_epi32(effective_food, zero_i)));
+        const __m256d value = _mm256_add_pd(food_value, _mm256_mul_pd(_mm256_cvtepi32_pd(effective_other), other_value));
+
+        const __m256d cost = _mm256_add_pd(fixed_cost, _mm256_mul_pd(alpha, trip_distance));
+        const __m256d net_value = _mm256_sub_pd(value, cost);
+
+        // beats(), per lane. A lane's best village is -1 or a candidate index, so "lower index"
+        // alone already excludes -1.
+        const __m256d tie = _mm256_and_pd(_mm256_cmp_pd(net_value, lane_net, _CMP_EQ_OQ), widenMask(_mm_cmpgt_epi32(lane_village, idx)));
+        const __m256d better = _mm256_and_pd(ok, _mm256_or_pd(_mm256_cmp_pd(net_value, lane_net, _CMP_GT_OQ), tie));
+        lane_net = _mm256_blendv_pd(lane_net, net_value, better);
+        lane_village = _mm_blendv_epi8(lane_village, idx, narrowMask(better));
+    }
+
+    alignas(32) double nets[4];
+    alignas(16) int villages[4];
+    _mm256_store_pd(nets, lane_net);
+    _mm_store_si128(reinterpret_cast<__m128i*>(villages), lane_village);
+    for (int lane = 0; lane < 4; ++lane) {
+        if (villages[lane] != -1 && beats(nets[lane], villages[lane], best)) {
+            best.village = villages[lane];
+            best.net_value = nets[lane];
+        }
+    }
+    // The lanes only track the winner; its load is cheaper to price again than to carry along.
+    if (best.village != -1) {
+        double net_value;
+        priceCandidate(scan, k, best.village, net_value, best.dry, best.perishable, best.other);
+    }
+
+    scanScalarRange(scan, k, candidates + c, count - c, best);
+    return best;
+}
+
+bool firstVillageScanHasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+
+#else // !VILLAGE_SCAN_X86
+
+FirstVillageChoice scanFirstVillageAvx2(const FirstVillageScan& scan, const int* candidates, size_t count) {
+    return scanFirstVillageScalar(scan, candidates, count);
+}
+
+bool firstVillageScanHasAvx2() {
+    return false;
+}
+
+#endif // VILLAGE_SCAN_X86
+
+FirstVillageChoice scanFirstVillage(const FirstVillageScan& scan, const int* candidates, size_t count) {
+    return firstVillageScanHasAvx2() && !scan.payload ? scanFirstVillageAvx2(scan, candidates, count) : scanFirstVillageScalar(scan, candidates, count);
+}
@@ -0,0 +1,95 @@
+#ifndef VILLAGE_SCAN_H
+#define VILLAGE_SCAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include "structures.h"
+#include "payload.h"
+
+/**
+ * @brief Value of delivering the given units to a village of the given population, with food
+ * capped at 9 units per person (perishable counted first) and other supplies at 1 per person.
+ * @param packages The three package types, in DRY, PERISHABLE, OTHER order.
+ */
+inline double villageDeliveryValue(int population, int dry_delivered, int perishable_delivered, int other_delivered, const PackageInfo* packages) {
+    int max_food_needed = 9 * population;
+    int max_other_needed = population;
+
+    int total_food_delivered = dry_delivered + perishable_delivered;
+    int effective_food = std::min(total_food_delivered, max_food_needed);
+    int effective_other = std::min(other_delivered, max_other_needed);
+
+    double food_value = 0;
+    if (effective_food > 0) {
+        int effective_perishable = std::min(perishable_delivered, effective_food);
+        food_value += effective_perishable * packages[1].value;
+
+        int remaining_food_need = effective_food - effective_perishable;
+        int effective_dry = std::min(dry_delivered, remaining_food_need);
+        food_value += effective_dry * packages[0].value;
+    }
+
+    double other_value = effective_other * packages[2].value;
+    return food_value + other_value;
+}
+
+/**
+ * @brief Structure-of-arrays view of everything the first-village scan reads, for one
+ * helicopter at one point of a construction pass.
+ *
+ * The per-village arrays are indexed by 0-based village index and are only read at the
+ * indices passed to scanFirstVillage, so the candidate list can be any subset in any order.
+ * Loads follow the ratio walk's dry_ratio unless a payload optimizer is given.
+ */
+struct FirstVillageScan {
+    const double* city_distance = nullptr; // Distance from the home city to each village.
+    const int* population = nullptr;
+    const int* rem_food = nullptr;         // Remaining demand of the current construction pass.
+    const int* rem_other = nullptr;
+    const PackageInfo* packages = nullptr; // DRY, PERISHABLE, OTHER.
+
+    double weight_capacity = 0.0;
+    double distance_capacity = 0.0;
+    double distance_budget = 0.0;          // What is left of DMax for this helicopter.
+    double fixed_cost = 0.0;
+    double alpha = 0.0;
+    double dry_ratio = 0.0;
+    double avg_food_weight = 0.0;
+    PayloadOptimizer* payload = nullptr;   // If set, each candidate gets its best load instead.
+};
+
+/**
+ * @brief Best out-and-back trip of a scan. village is -1 when no candidate has a positive net value.
+ */
+struct FirstVillageChoice {
+    int village = -1;
+    double net_value = 0.0;
+    int dry = 0, perishable = 0, other = 0;
+};
+
+/**
+ * @brief Prices a single out-and-back trip to each candidate with the load the scan's settings
+ * choose, and returns the one with the highest positive net value. Equal values go to the
+ * lower village index, so the result does not depend on the order of the candidates.
+ * Dispatches at run time to the AVX2 kernel when the CPU has it; both kernels return
+ * bit-identical results. Scans with a payload optimizer always run the scalar kernel.
+ */
+FirstVillageChoice scanFirstVillage(const FirstVillageScan& scan, const int* candidates, std::size_t count);
+
+/**
+ * @brief Portable one-candidate-at-a-time kernel.
+ */
+FirstVillageChoice scanFirstVillageScalar(const FirstVillageScan& scan, const int* candidates, std::size_t count);
+
+/**
+ * @brief Four candidates per instruction. Must only be called when firstVillageScanHasAvx2(),
+ * and only for ratio-walk scans (no payload optimizer).
+ */
+FirstVillageChoice scanFirstVillageAvx2(const FirstVillageScan& scan, const int* candidates, std::size_t count);
+
+/**
+ * @brief True if this build has the AVX2 kernel and the CPU it runs on supports it.
+ */
+bool firstVillageScanHasAvx2();
+
+#endif // VILLAGE_SCAN_H
@@ -0,0 +1,143 @@
+#include "warm_start.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+const int DRY = 0, PER = 1, OTH = 2;
+const double kEps = 1e-9;
+
+int& units(Drop& drop, int type) {
+    return type == DRY ? drop.dry_food : type == PER ? drop.perishable_food : drop.other_supplies;
+}
+
+double tripWeight(const ProblemData& problem, const vector<Drop>& drops) {
+    double weight = 0.0;
+    for (const auto& drop : drops) {
+        weight += drop.dry_food * problem.packages[DRY].weight + drop.perishable_food * problem.packages[PER].weight + drop.other_supplies * problem.packages[OTH].weight;
+    }
+    return weight;
+}
+
+} // namespace
+
+Solution repairWarmStart(const ProblemData& problem, const DistanceCache& dist, const Solution& prior, WarmStartReport& report) {
+    const int num_helicopters = static_cast<int>(problem.helicopters.size());
+    const int num_villages = static_cast<int>(problem.villages.size());
+    const auto& packages = problem.packages;
+    const bool perishable_first = packages[PER].value >= packages[DRY].value;
+
+    // Types in the order overweight trips give them up: least value per unit of weight first.
+    int shed_order[3] = {DRY, PER, OTH};
+    sort(shed_order, shed_order + 3, [&](int a, int b) {
+        return packages[a].value * packages[b].weight < packages[b].value * packages[a].weight;
+    });
+
+    vector<int> food_delivered(num_villages, 0), other_delivered(num_villages, 0);
+    vector<HelicopterPlan> by_helicopter(num_helicopters);
+    vector<double> distance_used(num_helicopters, 0.0);
+
+    for (const auto& plan : prior) {
+        const int h = plan.helicopter_id - 1;
+        if (h < 0 || h >= num_helicopters) {
+            report.trips_dropped += static_cast<int>(plan.trips.size());
+            continue;
+        }
+        const Helicopter& helicopter = problem.helicopters[h];
+        const int city = helicopter.home_city_id - 1;
+
+        for (const auto& in_trip : plan.trips) {
+            bool changed = false;
+            vector<Drop> drops;
+            drops.reserve(in_trip.drops.size());
+            for (Drop drop : in_trip.drops) {
+                const int v = drop.village_id - 1;
+                if (v < 0 || v >= num_villages) {
+                    changed = true;
+                    continue;
+                }
+                const Drop original = drop;
+                int food_room = 9 * problem.villages[v].population - food_delivered[v];
+                int other_room = problem.villages[v].population - other_delivered[v];
+                for (const auto& earlier : drops) {
+                    if (earlier.village_id != drop.village_id) continue;
+                    food_room -= earlier.dry_food + earlier.perishable_food;
+                    other_room -= earlier.other_supplies;
+                }
+                if (perishable_first) {
+                    drop.perishable_food = max(0, min(drop.perishable_food, food_room));
+                    drop.dry_food = max(0, min(drop.dry_food, food_room - drop.perishable_food));
+                } else {
+                    drop.dry_food = max(0, min(drop.dry_food, food_room));
+                    drop.perishable_food = max(0, min(drop.perishable_food, food_room - drop.dry_food));
+                }
+                drop.other_supplies = max(0, min(drop.other_supplies, other_room));
+                changed = changed || drop.dry_food != original.dry_food || drop.perishable_food != original.perishable_food || drop.other_supplies != original.other_supplies;
+                if (drop.dry_food + drop.perishable_food + drop.other_supplies > 0) drops.push_back(drop);
+            }
+
+            double excess = tripWeight(problem, drops) - helicopter.weight_capacity;
+            for (int i = static_cast<int>(drops.size()) - 1; i >= 0 && excess > kEps; --i) {
+                for (int type : shed_order) {
+                    const double w = packages[type].weight;
+                    int& count = units(drops[i], type);
+                    if (excess <= kEps || w <= kEps || count == 0) continue;
+                    const int shed = min(count, static_cast<int>(ceil(excess / w - kEps)));
+                    count -= shed;
+                    excess -= shed * w;
+                    changed = true;
+                }
+            }
+            drops.erase(remove_if(drops.begin(), drops.end(), [](const Drop& d) { return d.dry_food + d.perishable_food + d.other_supplies == 0; }), drops.end());
+
+            const double range = min(helicopter.distance_capacity, problem.d_max - distance_used[h]);
+            double trip_distance = dist.tripDistance(city, drops);
+            while (!drops.empty() && trip_distance > range + kEps) {
+                size_t best = 0;
+                double best_distance = 0.0;
+                for (size_t i = 0; i < drops.size(); ++i) {
+                    vector<Drop> without = drops;
+                    without.erase(without.begin() + i);
+                    const double d = dist.tripDistance(city, without);
+                    if (i == 0 || d < best_distance) {
+                        best = i;
+                        best_distance = d;
+                    }
+                }
+                drops.erase(drops.begin() + best);
+                trip_distance = best_distance;
+                changed = true;
+            }
+
+            if (drops.empty()) {
+                report.trips_dropped++;
+                continue;
+            }
+            if (changed) {
+                report.trips_repaired++;
+            } else {
+                report.trips_kept++;
+            }
+
+            Trip trip = {0, 0, 0, move(drops)};
+            for (const auto& drop : trip.drops) {
+                trip.dry_food_pickup += drop.dry_food;
+                trip.perishable_food_pickup += drop.perishable_food;
+                trip.other_supplies_pickup += drop.other_supplies;
+                food_delivered[drop.village_id - 1] += drop.dry_food + drop.perishable_food;
+                other_delivered[drop.village_id - 1] += drop.other_supplies;
+            }
+            distance_used[h] += trip_distance;
+            by_helicopter[h].helicopter_id = helicopter.id;
+            by_helicopter[h].trips.push_back(move(trip));
+        }
+    }
+
+    Solution repaired;
+    for (auto& plan : by_helicopter) {
+        if (!plan.trips.empty()) repaired.push_back(move(plan));
+    }
+    return repaired;
+}
@@ -0,0 +1,29 @@
+#ifndef WARM_START_H
+#define WARM_START_H
+
+#include "structures.h"
+#include "distance_cache.h"
+
+/**
+ * @brief What repairWarmStart() had to change to fit a prior plan to the current instance.
+ */
+struct WarmStartReport {
+    int trips_kept = 0;     // Trips taken over unchanged (pickups aside).
+    int trips_repaired = 0; // Trips kept with fewer units or fewer drops.
+    int trips_dropped = 0;  // Trips with nothing feasible left, or of helicopters no longer in the roster.
+};
+
+/**
+ * @brief Fits a plan written for an earlier version of an instance to the current one, matching
+ * helicopters and villages by ID.
+ *
+ * Trips are taken in plan order. Drops to villages that no longer exist are removed and every
+ * drop is cut to what its village still needs after the drops before it, most valuable food
+ * first. A trip that is now too heavy sheds its least valuable units per unit of weight, from
+ * its last drop backwards; one that is too long, for the helicopter's trip range or for what is
+ * left of its DMax, loses the drop whose removal shortens it most until it fits. Pickups are
+ * set to the sum of the drops. The result passes the grader's checks.
+ */
+Solution repairWarmStart(const ProblemData& problem, const DistanceCache& dist, const Solution& prior, WarmStartReport& report);
+
+#endif // WARM_START_H